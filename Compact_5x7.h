@@ -0,0 +1,117 @@
+#ifndef _COMPACT_5X7_H_
+#define _COMPACT_5X7_H_
+
+#include "framebuffer.h"
+
+// 5x7 monospaced font with digits, upper case letters and a few symbols.
+// Every glyph advances 6 pixels and its top row is the y given to print().
+inline constexpr uint8_t Compact_5x7Bitmaps[] FONT_DATA = {
+
+    // Bitmap Data:
+    0x01, 0x09, 0xF2, 0x10, 0x00,  // '+'
+    0x00, 0x01, 0xF0, 0x00, 0x00,  // '-'
+    0x00, 0x00, 0x00, 0x31, 0x80,  // '.'
+    0x00, 0x44, 0x44, 0x40, 0x00,  // '/'
+    0x74, 0x67, 0x5C, 0xC5, 0xC0,  // '0'
+    0x23, 0x08, 0x42, 0x11, 0xC0,  // '1'
+    0x74, 0x42, 0x22, 0x23, 0xE0,  // '2'
+    0xF8, 0x88, 0x20, 0xC5, 0xC0,  // '3'
+    0x11, 0x95, 0x2F, 0x88, 0x40,  // '4'
+    0xFC, 0x3C, 0x10, 0xC5, 0xC0,  // '5'
+    0x32, 0x21, 0xE8, 0xC5, 0xC0,  // '6'
+    0xF8, 0x44, 0x44, 0x21, 0x00,  // '7'
+    0x74, 0x62, 0xE8, 0xC5, 0xC0,  // '8'
+    0x74, 0x62, 0xF0, 0x89, 0x80,  // '9'
+    0x03, 0x18, 0x06, 0x30, 0x00,  // ':'
+    0x74, 0x63, 0xF8, 0xC6, 0x20,  // 'A'
+    0xF4, 0x63, 0xE8, 0xC7, 0xC0,  // 'B'
+    0x74, 0x61, 0x08, 0x45, 0xC0,  // 'C'
+    0xE4, 0xA3, 0x18, 0xCB, 0x80,  // 'D'
+    0xFC, 0x21, 0xE8, 0x43, 0xE0,  // 'E'
+    0xFC, 0x21, 0xE8, 0x42, 0x00,  // 'F'
+    0x74, 0x61, 0x78, 0xC5, 0xE0,  // 'G'
+    0x8C, 0x63, 0xF8, 0xC6, 0x20,  // 'H'
+    0x71, 0x08, 0x42, 0x11, 0xC0,  // 'I'
+    0x38, 0x84, 0x21, 0x49, 0x80,  // 'J'
+    0x8C, 0xA9, 0x8A, 0x4A, 0x20,  // 'K'
+    0x84, 0x21, 0x08, 0x43, 0xE0,  // 'L'
+    0x8E, 0xEB, 0x58, 0xC6, 0x20,  // 'M'
+    0x8C, 0x73, 0x59, 0xC6, 0x20,  // 'N'
+    0x74, 0x63, 0x18, 0xC5, 0xC0,  // 'O'
+    0xF4, 0x63, 0xE8, 0x42, 0x00,  // 'P'
+    0x74, 0x63, 0x1A, 0xC9, 0xA0,  // 'Q'
+    0xF4, 0x63, 0xEA, 0x4A, 0x20,  // 'R'
+    0x7C, 0x20, 0xE0, 0x87, 0xC0,  // 'S'
+    0xF9, 0x08, 0x42, 0x10, 0x80,  // 'T'
+    0x8C, 0x63, 0x18, 0xC5, 0xC0,  // 'U'
+    0x8C, 0x63, 0x18, 0xA8, 0x80,  // 'V'
+    0x8C, 0x63, 0x5A, 0xD5, 0x40,  // 'W'
+    0x8C, 0x54, 0x45, 0x46, 0x20,  // 'X'
+    0x8C, 0x54, 0x42, 0x10, 0x80,  // 'Y'
+    0xF8, 0x44, 0x44, 0x43, 0xE0  // 'Z'
+};
+inline constexpr GFXglyph Compact_5x7Glyphs[] FONT_DATA = {
+    // bitmapOffset, width, height, xAdvance, xOffset, yOffset
+    {0, 0, 0, 6, 0, 0},         // ' '
+    {0, 0, 0, 6, 0, 0},         // '!'
+    {0, 0, 0, 6, 0, 0},         // '"'
+    {0, 0, 0, 6, 0, 0},         // '#'
+    {0, 0, 0, 6, 0, 0},         // '$'
+    {0, 0, 0, 6, 0, 0},         // '%'
+    {0, 0, 0, 6, 0, 0},         // '&'
+    {0, 0, 0, 6, 0, 0},         // '\''
+    {0, 0, 0, 6, 0, 0},         // '('
+    {0, 0, 0, 6, 0, 0},         // ')'
+    {0, 0, 0, 6, 0, 0},         // '*'
+    {0, 5, 7, 6, 0, -7},        // '+'
+    {5, 0, 0, 6, 0, 0},         // ','
+    {5, 5, 7, 6, 0, -7},        // '-'
+    {10, 5, 7, 6, 0, -7},       // '.'
+    {15, 5, 7, 6, 0, -7},       // '/'
+    {20, 5, 7, 6, 0, -7},       // '0'
+    {25, 5, 7, 6, 0, -7},       // '1'
+    {30, 5, 7, 6, 0, -7},       // '2'
+    {35, 5, 7, 6, 0, -7},       // '3'
+    {40, 5, 7, 6, 0, -7},       // '4'
+    {45, 5, 7, 6, 0, -7},       // '5'
+    {50, 5, 7, 6, 0, -7},       // '6'
+    {55, 5, 7, 6, 0, -7},       // '7'
+    {60, 5, 7, 6, 0, -7},       // '8'
+    {65, 5, 7, 6, 0, -7},       // '9'
+    {70, 5, 7, 6, 0, -7},       // ':'
+    {75, 0, 0, 6, 0, 0},        // ';'
+    {75, 0, 0, 6, 0, 0},        // '<'
+    {75, 0, 0, 6, 0, 0},        // '='
+    {75, 0, 0, 6, 0, 0},        // '>'
+    {75, 0, 0, 6, 0, 0},        // '?'
+    {75, 0, 0, 6, 0, 0},        // '@'
+    {75, 5, 7, 6, 0, -7},       // 'A'
+    {80, 5, 7, 6, 0, -7},       // 'B'
+    {85, 5, 7, 6, 0, -7},       // 'C'
+    {90, 5, 7, 6, 0, -7},       // 'D'
+    {95, 5, 7, 6, 0, -7},       // 'E'
+    {100, 5, 7, 6, 0, -7},      // 'F'
+    {105, 5, 7, 6, 0, -7},      // 'G'
+    {110, 5, 7, 6, 0, -7},      // 'H'
+    {115, 5, 7, 6, 0, -7},      // 'I'
+    {120, 5, 7, 6, 0, -7},      // 'J'
+    {125, 5, 7, 6, 0, -7},      // 'K'
+    {130, 5, 7, 6, 0, -7},      // 'L'
+    {135, 5, 7, 6, 0, -7},      // 'M'
+    {140, 5, 7, 6, 0, -7},      // 'N'
+    {145, 5, 7, 6, 0, -7},      // 'O'
+    {150, 5, 7, 6, 0, -7},      // 'P'
+    {155, 5, 7, 6, 0, -7},      // 'Q'
+    {160, 5, 7, 6, 0, -7},      // 'R'
+    {165, 5, 7, 6, 0, -7},      // 'S'
+    {170, 5, 7, 6, 0, -7},      // 'T'
+    {175, 5, 7, 6, 0, -7},      // 'U'
+    {180, 5, 7, 6, 0, -7},      // 'V'
+    {185, 5, 7, 6, 0, -7},      // 'W'
+    {190, 5, 7, 6, 0, -7},      // 'X'
+    {195, 5, 7, 6, 0, -7},      // 'Y'
+    {200, 5, 7, 6, 0, -7}       // 'Z'
+};
+inline constexpr GFXfont Compact_5x7 FONT_DATA = {Compact_5x7Bitmaps, Compact_5x7Glyphs, 0x20, 0x5A, 7};
+
+#endif
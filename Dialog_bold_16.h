@@ -1,4 +1,9 @@
-const uint8_t Dialog_bold_16Bitmaps[] = {
+#ifndef _DIALOG_BOLD_16_H_
+#define _DIALOG_BOLD_16_H_
+
+#include "framebuffer.h"
+
+inline constexpr uint8_t Dialog_bold_16Bitmaps[] FONT_DATA = {
 
     // Bitmap Data:
     0x00,                          // ' '
@@ -163,7 +168,7 @@ const uint8_t Dialog_bold_16Bitmaps[] = {
     0xE1, 0xE0, 0xC1, 0x83, 0x06, 0x0C, 0x1E, 0x3C, 0x60, 0xC1, 0x83,
     0x1E, 0x38, 0x00  // '}'
 };
-const GFXglyph Dialog_bold_16Glyphs[] = {
+inline constexpr GFXglyph Dialog_bold_16Glyphs[] FONT_DATA = {
     // bitmapOffset, width, height, xAdvance, xOffset, yOffset
     {0, 1, 1, 7, 0, 0},         // ' '
     {1, 3, 12, 8, 2, -12},      // '!'
@@ -260,6 +265,6 @@ const GFXglyph Dialog_bold_16Glyphs[] = {
     {1206, 3, 16, 7, 2, -12},   // '|'
     {1212, 7, 15, 12, 2, -12}   // '}'
 };
-const GFXfont Dialog_bold_16 = {(uint8_t*)Dialog_bold_16Bitmaps,
-                                (GFXglyph*)Dialog_bold_16Glyphs, 0x20, 0x7E,
-                                19};
\ No newline at end of file
+inline constexpr GFXfont Dialog_bold_16 FONT_DATA = {Dialog_bold_16Bitmaps, Dialog_bold_16Glyphs, 0x20, 0x7E, 19};
+
+#endif
@@ -1,49 +1,55 @@
-#include <cstdio>
 #include <cstring>
 
 #include "OLED.h"
 #include "Dialog_bold_16.h"
 
+// The flush path and the text and blit kernels run from SRAM, with the
+// framebuffer kernels they use forced inline into them, so a frame does not
+// miss the XIP cache on code
+
+// Direct writes wait for a flush in progress to end first
 
 void OLED::write_cmd(uint8_t cmd) {
+    wait();
     // 0x00 for write command
     uint8_t buff[] = {0x00, cmd};
-    i2c_write_blocking(I2C_PORT, OLED_ADDRESS, buff, 2, false);
+    BUS->write(OLED_ADDRESS, buff, 2);
+}
+
+void OLED::write_cmds(const uint8_t* cmds, uint8_t count) {
+    wait();
+    // 0x00 for write command, followed by all commands in one transfer
+    uint8_t buff[8] = {0x00};
+    memcpy(buff + 1, cmds, count);
+    BUS->write(OLED_ADDRESS, buff, count + 1);
 }
 
 void OLED::write_data(uint8_t data) {
+    wait();
     // 0x40 for write data
     uint8_t buff[] = {0x40, data};
-    i2c_write_blocking(I2C_PORT, OLED_ADDRESS, buff, 2, false);
-}
-
-void OLED::swap(uint8_t* x1, uint8_t* x2) {
-    uint8_t temp = *x1;
-    *x1 = *x2, *x2 = temp;
-}
-
-bool OLED::bitRead(uint8_t character, uint8_t index) {
-    return bool((character >> index) & 0x01);
+    BUS->write(OLED_ADDRESS, buff, 2);
 }
 
 void OLED::init() {
     // Display init
     write_cmd(SET_DISP | 0x00);
-    // Set horizontal address mode
-    write_cmd(SET_MEM_ADDR);
-    write_cmd(0x00);
+    // Set horizontal address mode, the SH1106 only has page addressing
+    if (CONTROLLER == OLED_SSD1306) {
+        write_cmd(SET_MEM_ADDR);
+        write_cmd(0x00);
+        VERTICAL = false;
+    }
     // Start line from 0
     write_cmd(SET_DISP_START_LINE);
-    // Set seg-map
-    write_cmd(SET_SEG_REMAP | 0x01);
+    // Set seg-map and COM output scan direction for the rotation
+    setRemap();
     // Set oled height
     write_cmd(SET_MUX_RATIO);
     write_cmd(HEIGHT - 1);
-    // Set COM output scan directionscan from bottom up, COM[0] to COM[N-1]
-    write_cmd(SET_COM_OUT_DIR | 0x08);
     // Set display offset
     write_cmd(SET_DISP_OFFSET);
-    write_cmd(0x00);
+    write_cmd(SHIFT);
     // Set COM pins hardware configuration,0x12 for 12864,and 0x02 for 12832
     write_cmd(SET_COM_PIN_CFG);
     if (HEIGHT == 64)
@@ -66,42 +72,118 @@ void OLED::init() {
     write_cmd(SET_ENTIRE_ON);
     // NO inverse , which '0' for pixel off, '1' for pixel on
     write_cmd(SET_NORM_INV);
-    // Set charge pump
-    write_cmd(SET_CHARGE_PUMP);
-    write_cmd(0x14);
-    // Set scroll disable
-    write_cmd(SET_SCROLL | 0x00);
+    if (CONTROLLER == OLED_SSD1306) {
+        // Set charge pump
+        write_cmd(SET_CHARGE_PUMP);
+        write_cmd(0x14);
+        // Set scroll disable
+        write_cmd(SET_SCROLL | 0x00);
+    }
+    else {
+        // Set DC-DC converter on
+        write_cmd(SET_DC_DC);
+        write_cmd(0x8B);
+    }
+    clearUnusedPages();
     // Turn oled on
     write_cmd(SET_DISP | 0x01);
 }
 
+// The display offset counts over the 64 rows of the display RAM, so a panel
+// with fewer rows shows the pages below its own when shifted. The driver
+// never writes them; they are cleared once, and rows moved in are blank.
+void OLED::clearUnusedPages() {
+    uint8_t data[1 + 132] = {0x40};  // 0x40 for write data, all columns of either controller
+    for (uint8_t page = PAGES; page < 8; page++) {
+        if (CONTROLLER == OLED_SSD1306) {
+            uint8_t window[] = {SET_COL_ADDR, 0, 127, SET_PAGE_ADDR, page, page};
+            write_cmds(window, sizeof(window));
+            BUS->write(OLED_ADDRESS, data, 1 + 128);
+        }
+        else {
+            uint8_t window[] = {(uint8_t)(SET_PAGE_START | page), SET_LOW_COL, SET_HIGH_COL};
+            write_cmds(window, sizeof(window));
+            BUS->write(OLED_ADDRESS, data, 1 + 132);
+        }
+    }
+}
+
 OLED::OLED(uint8_t scl,
            uint8_t sda,
            uint8_t width,
            uint8_t height,
            uint32_t freq,
-           i2c_inst_t* i2c) {
+           i2c_inst_t* i2c,
+           uint8_t controller) {
     // OLED object init
 
     WIDTH = width, HEIGHT = height;
-    PAGES = height / 8, BUFFERSIZE = width * PAGES;
+    PAGES = height / 8;
     OLED_SDA_PIN = sda, OLED_SCL_PIN = scl;
-    FREQUENCY = freq, I2C_PORT = i2c;
-    myFont = &Dialog_bold_16;
-
-    clear();
-    // i2c init
-    i2c_init(I2C_PORT, FREQUENCY);
-    gpio_set_function(OLED_SDA_PIN, GPIO_FUNC_I2C);
-    gpio_set_function(OLED_SCL_PIN, GPIO_FUNC_I2C);
-    gpio_pull_up(OLED_SDA_PIN);
-    gpio_pull_up(OLED_SCL_PIN);
+    FREQUENCY = freq;
+    CONTROLLER = controller;
+    ROTATION = OLED_ROTATE_0;
+    SHIFT = 0;
+    COL_SHIFT = 0;
+    FB.init(width, height, &Dialog_bold_16);
+    FLUSH_COUNT = 0;
+
+    // The bus may already be set up by another device on it
+    BUS = &i2c_bus(i2c);
+    BUS->init(OLED_SCL_PIN, OLED_SDA_PIN, FREQUENCY);
     // Display init
     init();
 }
 
 OLED::~OLED() {}
 
+// Initialises the display again and sends the whole buffer at the next show,
+// e.g. after a transfer may have been cut off
+void OLED::reset() {
+    init();
+    FB.markDirty(0, 0, FB.WIDTH, FB.HEIGHT);
+}
+
+// Returns the rate that is actually set
+uint32_t OLED::setFrequency(uint32_t freq) {
+    wait();
+    FREQUENCY = BUS->setFrequency(freq);
+    return FREQUENCY;
+}
+
+// Sends the whole buffer with its address commands, and returns false if
+// any byte is not acknowledged. The SH1106 can also be read, its status
+// must say that the display is on; it is read after a command control
+// byte, as after data the SH1106 returns display RAM instead. A failed check may leave a command
+// half sent, see reset().
+bool OLED::verifyBus() {
+    wait();
+    for (uint8_t page = 0; page < PAGES; page++) {
+        if (CONTROLLER == OLED_SSD1306 && page == 0) {
+            uint8_t window[] = {0x00, SET_MEM_ADDR, 0x00, SET_COL_ADDR, 0, (uint8_t)(WIDTH - 1),
+                                SET_PAGE_ADDR, 0, (uint8_t)(PAGES - 1)};
+            if (!BUS->write(OLED_ADDRESS, window, sizeof(window)))
+                return false;
+            VERTICAL = false;
+        }
+        else if (CONTROLLER == OLED_SH1106) {
+            uint8_t window[] = {0x00, (uint8_t)(SET_PAGE_START | page), SET_LOW_COL | SH1106_COL_OFFSET, SET_HIGH_COL};
+            if (!BUS->write(OLED_ADDRESS, window, sizeof(window)))
+                return false;
+        }
+        TXBUF[0] = 0x40;
+        copyPage(page, 0, WIDTH - 1, TXBUF + 1);
+        if (!BUS->write(OLED_ADDRESS, TXBUF, WIDTH + 1))
+            return false;
+    }
+    if (CONTROLLER == OLED_SH1106) {
+        uint8_t control = 0x00, status;
+        if (!BUS->transfer(OLED_ADDRESS, &control, 1, &status, 1) || (status & 0x40))
+            return false;
+    }
+    return true;
+}
+
 void OLED::isDisplay(bool display) {
     write_cmd(SET_DISP | display);
 }
@@ -111,110 +193,330 @@ void OLED::setContrast(uint8_t contrast) {
     write_cmd(contrast);
 }
 
+// The panel mirrors columns and rows by itself, which turns the image by 180.
+// A quarter turn is a transpose at flush time followed by one of the mirrors.
+void OLED::setRemap() {
+    static const uint8_t remap[4][2] = {
+        {SET_SEG_REMAP | 0x01, SET_COM_OUT_DIR | 0x08},  // COM[N-1] to COM[0]
+        {SET_SEG_REMAP | 0x00, SET_COM_OUT_DIR | 0x08},  // Transposed, columns mirrored
+        {SET_SEG_REMAP | 0x00, SET_COM_OUT_DIR | 0x00},
+        {SET_SEG_REMAP | 0x01, SET_COM_OUT_DIR | 0x00},  // Transposed, rows mirrored
+    };
+    write_cmds(remap[ROTATION], 2);
+}
+
+// Clears the image, it has to be drawn again
+void OLED::setRotation(uint8_t rotation) {
+    ROTATION = rotation & 0x03;
+    setRemap();
+    bool quarter = ROTATION & 0x01;
+    FB.init(quarter ? HEIGHT : WIDTH, quarter ? WIDTH : HEIGHT, FB.FONT);
+}
+
+// Moves the whole image by steps against burn-in, and blank rows or
+// columns come in. On a panel shorter than the 64 rows of the display RAM
+// these are rows along the COM lines, with the display offset: two command
+// bytes, and nothing is sent again, see clearUnusedPages(). On a 64-row
+// panel the offset would bring the rows pushed off one edge back at the
+// other, so the image moves by columns through the column window instead.
+// The columns it leaves are cleared, and it is sent again at the next show.
+void OLED::setShift(int8_t steps) {
+    if (HEIGHT < 64) {
+        SHIFT = (64 + steps % 64) % 64;  // The offset register counts over 64 rows
+        uint8_t cmds[] = {SET_DISP_OFFSET, SHIFT};
+        write_cmds(cmds, sizeof(cmds));
+        return;
+    }
+    if (steps >= WIDTH || steps <= -WIDTH)
+        steps = 0;
+    COL_SHIFT = steps;
+    if (steps > 0)
+        clearColumns(0, steps - 1);
+    else if (steps < 0)
+        clearColumns(WIDTH + steps, WIDTH - 1);
+    FB.markDirty(0, 0, FB.WIDTH, FB.HEIGHT);
+}
+
+// Clears the columns x0 to x1 of all pages of the panel
+void OLED::clearColumns(uint8_t x0, uint8_t x1) {
+    uint8_t data[1 + 128] = {0x40};  // 0x40 for write data
+    uint8_t columns = x1 - x0 + 1;
+    if (CONTROLLER == OLED_SSD1306) {
+        // In horizontal addressing the window runs on to the next page
+        uint8_t mode[] = {SET_MEM_ADDR, 0x00};
+        uint8_t window[] = {SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, 0, (uint8_t)(PAGES - 1)};
+        write_cmds(mode, sizeof(mode));
+        write_cmds(window, sizeof(window));
+        VERTICAL = false;
+        for (uint8_t page = 0; page < PAGES; page++)
+            BUS->write(OLED_ADDRESS, data, 1 + columns);
+        return;
+    }
+    uint8_t column = x0 + SH1106_COL_OFFSET;
+    for (uint8_t page = 0; page < PAGES; page++) {
+        uint8_t window[] = {(uint8_t)(SET_PAGE_START | page), (uint8_t)(SET_LOW_COL | (column & 0x0F)),
+                            (uint8_t)(SET_HIGH_COL | (column >> 4))};
+        write_cmds(window, sizeof(window));
+        BUS->write(OLED_ADDRESS, data, 1 + columns);
+    }
+}
+
+uint8_t OLED::getWidth() {
+    return FB.WIDTH;
+}
+
+uint8_t OLED::getHeight() {
+    return FB.HEIGHT;
+}
+
 void OLED::isInverse(bool inverse) {
     write_cmd(SET_NORM_INV | inverse);
 }
 
 void OLED::clear() {
-    for (uint16_t i = 0; i < BUFFERSIZE; i++) {
-        BUFFER[i] = 0x00;
+    FB.clear();
+}
+
+void __not_in_flash("oled") OLED::clearRegion(uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    FB.fillRect(x, y, width, height, 0);
+}
+
+void OLED::invertRegion(uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    FB.invertRect(x, y, width, height);
+}
+
+// Starts the next transaction of the flush, for the given pages and columns
+// of the panel
+void __not_in_flash("oled") OLED::beginTransaction(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1) {
+    uint8_t* window = FLUSH_WINDOW[FLUSH_COUNT];
+    window[0] = page0, window[1] = page1, window[2] = x0, window[3] = x1;
+    I2CTransaction* t = FLUSH + FLUSH_COUNT++;
+    t->words = STREAM + STREAM_LENGTH;
+    t->count = 0;
+    t->address = OLED_ADDRESS;
+    t->priority = I2C_PRIORITY_DISPLAY;
+    t->rx = nullptr, t->rx_count = 0;
+}
+
+// Returns room for count words at the end of the current transaction
+uint16_t* __not_in_flash("oled") OLED::streamWords(uint16_t count) {
+    uint16_t* out = STREAM + STREAM_LENGTH;
+    STREAM_LENGTH += count;
+    FLUSH[FLUSH_COUNT - 1].count += count;
+    return out;
+}
+
+// 0x80 before each command says that a control byte follows it, so data
+// can come after the commands in the same transaction
+void __not_in_flash("oled") OLED::streamCommands(const uint8_t* cmds, uint8_t count) {
+    uint16_t* out = streamWords(2 * count);
+    for (uint8_t i = 0; i < count; i++)
+        out[2 * i] = 0x80, out[2 * i + 1] = cmds[i];
+}
+
+// Addresses the columns x0 to x1 of the pages page0 to page1, moved by
+// COL_SHIFT; vertical sends the window column by column, on the SSD1306 only
+void __not_in_flash("oled") OLED::setWindow(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, bool vertical) {
+    x0 += COL_SHIFT, x1 += COL_SHIFT;
+    if (CONTROLLER == OLED_SSD1306) {
+        // The addressing mode is only sent when it changes
+        if (vertical != VERTICAL) {
+            uint8_t mode[] = {SET_MEM_ADDR, vertical};
+            streamCommands(mode, sizeof(mode));
+            VERTICAL = vertical;
+        }
+        uint8_t address[] = {SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, page0, page1};
+        streamCommands(address, sizeof(address));
+    }
+    else {
+        // Page addressing only wraps within the page, one page at a time
+        uint8_t column = x0 + SH1106_COL_OFFSET;
+        uint8_t window[] = {(uint8_t)(SET_PAGE_START | page0), (uint8_t)(SET_LOW_COL | (column & 0x0F)),
+                            (uint8_t)(SET_HIGH_COL | (column >> 4))};
+        streamCommands(window, sizeof(window));
     }
 }
 
+// Transposes an 8x8 bit matrix, bit k of byte j moves to bit j of byte k
+static inline uint64_t transpose8x8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+// Collects the changed columns of each page of the panel and marks the image clean
+void __not_in_flash("oled") OLED::dirtyColumns(uint8_t* x0, uint8_t* x1) {
+    if (!(ROTATION & 0x01)) {
+        for (uint8_t page = 0; page < PAGES; page++) {
+            x0[page] = FB.DIRTY_X0[page], x1[page] = FB.DIRTY_X1[page];
+            FB.markClean(page);
+        }
+        return;
+    }
+    // Turned by a quarter: page p of the image is the 8 columns from 8p of
+    // the panel, and its columns from 8q are page q of the panel
+    memset(x0, 0xFF, PAGES);
+    memset(x1, 0, PAGES);
+    for (uint8_t p = 0; p < WIDTH / 8; p++) {
+        if (!FB.isDirty(p))
+            continue;
+        for (uint8_t page = FB.DIRTY_X0[p] / 8; page <= FB.DIRTY_X1[p] / 8; page++) {
+            x0[page] = (8 * p < x0[page]) ? 8 * p : x0[page];
+            x1[page] = (8 * p + 7 > x1[page]) ? 8 * p + 7 : x1[page];
+        }
+        FB.markClean(p);
+    }
+}
+
+// Copies the columns x0 to x1 of a page of the panel from the image
+void __not_in_flash("oled") OLED::copyPage(uint8_t page, uint8_t x0, uint8_t x1, uint8_t* out) {
+    if (!(ROTATION & 0x01)) {
+        memcpy(out, FB.DATA + WIDTH * page + x0, x1 - x0 + 1);
+        return;
+    }
+    // Each 8x8 block of the panel is a transposed block of the image
+    uint8_t blocks[128];
+    for (uint8_t block = x0 / 8; block <= x1 / 8; block++) {
+        uint64_t bits;
+        memcpy(&bits, FB.DATA + FB.WIDTH * block + 8 * page, 8);
+        bits = transpose8x8(bits);
+        memcpy(blocks + 8 * block, &bits, 8);
+    }
+    memcpy(out, blocks + x0, x1 - x0 + 1);
+}
+
 void OLED::show() {
-    // Set col, row, and page address for sending data buffer
-    write_cmd(SET_COL_ADDR);
-    write_cmd(0);
-    write_cmd(WIDTH - 1);
-    write_cmd(SET_PAGE_ADDR);
-    write_cmd(0);
-    write_cmd(PAGES - 1);
-    for (uint16_t i = 0; i < BUFFERSIZE; i++) {
-        write_data(BUFFER[i]);
+    showAsync();
+    wait();
+}
+
+// Queues the changes since the last flush and returns. The buffer can be
+// drawn into right away, the data to send is already copied.
+void __not_in_flash("oled") OLED::showAsync() {
+    wait();
+    // Only the columns that changed since the last show are sent, and pages
+    // without changes are skipped
+    uint8_t x0[8], x1[8];
+    dirtyColumns(x0, x1);
+    // Moved by COL_SHIFT, the columns off the panel are not sent
+    uint8_t shown0 = (COL_SHIFT < 0) ? -COL_SHIFT : 0;
+    uint8_t shown1 = (COL_SHIFT > 0) ? WIDTH - 1 - COL_SHIFT : WIDTH - 1;
+    for (uint8_t page = 0; page < PAGES; page++) {
+        x0[page] = (x0[page] < shown0) ? shown0 : x0[page];
+        x1[page] = (x1[page] > shown1) ? shown1 : x1[page];
+    }
+    STREAM_LENGTH = 0;
+    FLUSH_COUNT = 0;
+    for (uint8_t page = 0; page < PAGES;) {
+        if (x0[page] > x1[page]) {
+            page++;
+            continue;
+        }
+        // On the SSD1306, following pages with the same columns share one window
+        uint8_t last = page;
+        if (CONTROLLER == OLED_SSD1306)
+            while (last + 1 < PAGES && x0[last + 1] == x0[page] && x1[last + 1] == x1[page])
+                last++;
+        uint8_t columns = x1[page] - x0[page] + 1;
+        uint8_t pages = last - page + 1;
+        // Runs of several pages taller than wide, e.g. a bar or a cursor, go
+        // out column by column in vertical addressing, as one transaction. A
+        // single page is sent the same in either mode, so it keeps the mode
+        // the controller is in and needs no mode command.
+        bool vertical = (CONTROLLER == OLED_SSD1306) && (pages > 1 ? pages * 8 > columns : VERTICAL == 1);
+        beginTransaction(page, vertical ? last : page, x0[page], x1[page]);
+        setWindow(page, last, x0[page], x1[page], vertical);
+        if (vertical) {
+            uint16_t* out = streamWords(1 + columns * pages);
+            out[0] = 0x40;
+            for (uint8_t p = 0; p < pages; p++) {
+                copyPage(page + p, x0[page], x1[page], TXBUF);
+                for (uint8_t column = 0; column < columns; column++)
+                    out[1 + column * pages + p] = TXBUF[column];
+            }
+            out[columns * pages] |= I2C_IC_DATA_CMD_STOP_BITS;
+            page = last + 1;
+            continue;
+        }
+        // The following pages of a run continue where the window left off,
+        // whatever the bus sent to other devices in between
+        for (uint8_t first = page; page <= last; page++) {
+            if (page != first)
+                beginTransaction(page, page, x0[page], x1[page]);
+            // 0x40 for write data, one page row per transaction
+            uint16_t* out = streamWords(1 + columns);
+            out[0] = 0x40;
+            copyPage(page, x0[page], x1[page], TXBUF);
+            for (uint8_t column = 0; column < columns; column++)
+                out[1 + column] = TXBUF[column];
+            out[columns] |= I2C_IC_DATA_CMD_STOP_BITS;
+        }
     }
+    for (uint8_t i = 0; i < FLUSH_COUNT; i++)
+        BUS->submit(FLUSH + i);
 }
 
-void OLED::drawPixel(uint8_t x, uint8_t y) {
-    if (x < WIDTH && y < HEIGHT)
-        BUFFER[x + WIDTH * (y / 8)] |= 0x01 << (y % 8);
+// Waits until the flush in progress is on the display. A transaction that
+// is not acknowledged, e.g. on a marginal bus clock, is sent again with the
+// next flush, and so are the ones after it: a page continuing a window may
+// have been written to the wrong place.
+void OLED::wait() {
+    bool failed = false;
+    for (uint8_t i = 0; i < FLUSH_COUNT; i++) {
+        failed = !BUS->wait(FLUSH + i) || failed;
+        if (!failed)
+            continue;
+        const uint8_t* window = FLUSH_WINDOW[i];
+        uint8_t pages = window[1] - window[0] + 1, columns = window[3] - window[2] + 1;
+        // Turned by a quarter, the pages of the panel are columns of the image
+        if (ROTATION & 0x01)
+            FB.markDirty(8 * window[0], window[2], 8 * pages, columns);
+        else
+            FB.markDirty(window[2], 8 * window[0], columns, 8 * pages);
+        VERTICAL = -1;  // The mode command may not have arrived
+    }
+    FLUSH_COUNT = 0;
 }
 
 void OLED::drawFastHLine(uint8_t x, uint8_t y, uint8_t width) {
-    for (uint8_t i = 0; i < width; i++) {
-        drawPixel(x + i, y);
-    }
+    FB.fillRect(x, y, width, 1, FB.LEVEL);
 }
 
 void OLED::drawFastVLine(uint8_t x, uint8_t y, uint8_t height) {
-    for (uint8_t i = 0; i < height; i++) {
-        drawPixel(x, y + i);
-    }
+    FB.fillRect(x, y, 1, height, FB.LEVEL);
 }
 
 void OLED::drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2) {
-    if (x1 > x2) {
-        swap(&x1, &x2);
-        swap(&y1, &y2);
-    }
-    float m = (float)(y2 - y1) / (float)(x2 - x1);
-    for (uint8_t x = x1; x <= x2; x++) {
-        float y = m * (float)(x - x1) + (float)y1;
-        drawPixel(x, y);
-    }
+    FB.drawLine(x1, y1, x2, y2);
 }
 
 void OLED::drawCircle(int16_t xc, int16_t yc, uint16_t r) {
-    int16_t x = -r;
-    int16_t y = 0;
-    int16_t e = 2 - (2 * r);
-    do {
-        drawPixel(xc + x, yc - y);
-        drawPixel(xc - x, yc + y);
-        drawPixel(xc + y, yc + x);
-        drawPixel(xc - y, yc - x);
-        int16_t _e = e;
-        if (_e <= y)
-            e += (++y * 2) + 1;
-        if ((_e > x) || (e > y))
-            e += (++x * 2) + 1;
-    } while (x < 0);
+    FB.drawCircle(xc, yc, r);
 }
 
 void OLED::drawFilledCircle(int16_t xc, int16_t yc, uint16_t r) {
-    int16_t x = r;
-    int16_t y = 0;
-    int16_t e = 1 - x;
-    while (x >= y) {
-        drawLine(xc + x, yc + y, xc - x, yc + y);
-        drawLine(xc + y, yc + x, xc - y, yc + x);
-        drawLine(xc - x, yc - y, xc + x, yc - y);
-        drawLine(xc - y, yc - x, xc + y, yc - x);
-        ++y;
-        if (e >= 0) {
-            x--;
-            e += 2 * ((y - x) + 1);
-        } else
-            e += (2 * y) + 1;
-    }
+    FB.drawFilledCircle(xc, yc, r);
 }
 
 void OLED::drawRectangle(uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
-    drawFastHLine(x, y, width);
-    drawFastHLine(x, y + height - 1, width);
-    drawFastVLine(x, y, height);
-    drawFastVLine(x + width - 1, y, height);
+    FB.drawRectangle(x, y, width, height);
 }
 
 void OLED::drawFilledRectangle(uint8_t x,
                                uint8_t y,
                                uint8_t width,
                                uint8_t height) {
-    for (uint8_t i = 0; i < height; i++) {
-        drawFastHLine(x, y+i, width);
-    }
+    FB.fillRect(x, y, width, height, FB.LEVEL);
 }
 
 void OLED::setScrollDir(bool direction) {
+    if (CONTROLLER != OLED_SSD1306)
+        return;  // No hardware scrolling
     write_cmd(SET_HOR_SCROLL | direction);
     write_cmd(0x00);       // Dummy byte
     write_cmd(0);          // Start page
@@ -225,50 +527,29 @@ void OLED::setScrollDir(bool direction) {
 }
 
 void OLED::isScroll(bool isEnable) {
+    if (CONTROLLER != OLED_SSD1306)
+        return;
     write_cmd(SET_SCROLL | isEnable);
 }
 
 void OLED::setFont(const GFXfont* font) {
-    myFont = font;
+    FB.FONT = font;
 }
 
-void OLED::printChar(uint8_t x, uint8_t y, uint8_t character) {
-    if (character < myFont->first || character > myFont->last)
-        return;
-    character -= myFont->first;
-    GFXglyph* glyph = myFont->glyph + character;
-    uint8_t* bitmap = myFont->bitmap;
-
-    uint16_t bitmapOffset = glyph->bitmapOffset;
-    uint8_t width = glyph->width, height = glyph->height;
-    int8_t xOffset = glyph->xOffset;
-    uint8_t yOffset = myFont->yAdvance + glyph->yOffset;
-    uint8_t bits = 0, abit = 0;
-
-    for (uint8_t i = 0; i < height; i++) {
-        for (uint8_t j = 0; j < width; j++) {
-            if (!(abit++ & 7)) {
-                bits = bitmap[bitmapOffset++];
-            }
-            if (bits & 0x80) {
-                drawPixel(x + xOffset + j, y + yOffset + i);
-            }
-            bits <<= 1;
-        }
-    }
+const GFXfont* OLED::getFont() {
+    return FB.FONT;
 }
 
-void OLED::print(uint8_t x, uint8_t y, uint8_t* string) {
-    for (uint8_t i = 0; string[i]; i++) {
-        uint8_t character = string[i];
-        GFXglyph* glyph = myFont->glyph + character - myFont->first;
-        if (x + glyph->width + glyph->xOffset > WIDTH) {
-            x = 0;
-            y += myFont->yAdvance;
-        }
-        printChar(x, y, character);
-        x += glyph->xAdvance;
-    }
+void __not_in_flash("oled") OLED::printChar(uint8_t x, uint8_t y, uint8_t character) {
+    FB.drawChar(x, y, character);
+}
+
+void __not_in_flash("oled") OLED::print(uint8_t x, uint8_t y, uint8_t* string) {
+    FB.print(x, y, (const char*)string);
+}
+
+void __not_in_flash("oled") OLED::drawColumns(uint8_t x, uint8_t page, uint8_t width, const uint8_t* columns) {
+    FB.drawColumns(x, page, width, columns);
 }
 
 void OLED::drawBitmap(uint8_t x,
@@ -276,12 +557,5 @@ void OLED::drawBitmap(uint8_t x,
                       uint8_t width,
                       uint8_t height,
                       const uint8_t* image) {
-    for (uint8_t i = 0; i < height; i++)
-        for (uint8_t j = 0; j < width; j++) {
-            bool value =
-                bitRead(image[i * ((width - 1) / 8 + 1) + j / 8], 7 - j % 8);
-            if (value) {
-                drawPixel(x + j, y + i);
-            }
-        }
-}
\ No newline at end of file
+    FB.drawBitmap(x, y, width, height, image);
+}
@@ -1,11 +1,22 @@
 #ifndef _OLED_H_
 #define _OLED_H_
 
-#include "hardware/i2c.h"
 #include "pico/stdlib.h"
+#include "framebuffer.h"
+#include "i2cbus.h"
 
 #define OLED_ADDRESS 0x3C
 
+// Controllers
+#define OLED_SSD1306 0
+#define OLED_SH1106 1  // 132 columns, page addressing only
+
+// Rotations, clockwise
+#define OLED_ROTATE_0 0
+#define OLED_ROTATE_90 1
+#define OLED_ROTATE_180 2
+#define OLED_ROTATE_270 3
+
 #define SET_CONTRAST 0x81
 #define SET_ENTIRE_ON 0xA4
 #define SET_NORM_INV 0xA6
@@ -26,45 +37,55 @@
 #define SET_SCROLL 0x2E
 #define SET_HOR_SCROLL 0x26
 
-struct GFXglyph {
-    uint16_t bitmapOffset;  ///< Pointer into GFXfont->bitmap
-    uint8_t width;          ///< Bitmap dimensions in pixels
-    uint8_t height;         ///< Bitmap dimensions in pixels
-    uint8_t xAdvance;       ///< Distance to advance cursor (x axis)
-    int8_t xOffset;         ///< X dist from cursor pos to UL corner
-    int8_t yOffset;         ///< Y dist from cursor pos to UL corner
-};
-
-struct GFXfont {
-    uint8_t* bitmap;   ///< Glyph bitmaps, concatenated
-    GFXglyph* glyph;   ///< Glyph array
-    uint8_t first;     ///< ASCII extents (first char)
-    uint8_t last;      ///< ASCII extents (last char)
-    uint8_t yAdvance;  ///< Newline distance (y axis)
-};
+// SH1106 only
+#define SET_PAGE_START 0xB0
+#define SET_LOW_COL 0x00
+#define SET_HIGH_COL 0x10
+#define SET_DC_DC 0xAD
+#define SH1106_COL_OFFSET 2  // The 128 visible columns are 2 to 129
 
 class OLED {
    private:
     uint32_t FREQUENCY;
-    i2c_inst_t* I2C_PORT;
+    I2CBus* BUS;
 
     // Pin Definition
     uint8_t OLED_SDA_PIN;
     uint8_t OLED_SCL_PIN;
 
-    uint8_t WIDTH;
+    uint8_t CONTROLLER;
+    uint8_t WIDTH;  // Of the panel, the image is HEIGHT wide when it is turned by 90 or 270
     uint8_t HEIGHT;
     uint8_t PAGES;
-    uint16_t BUFFERSIZE;
-    uint8_t BUFFER[1024];
-    const GFXfont* myFont;
+    uint8_t ROTATION;
+    uint8_t SHIFT;  // Display offset in rows, see setShift()
+    int8_t COL_SHIFT;  // Columns the image is moved by on a 64-row panel
+    Framebuffer<Mono1PageMajor, 128, 64> FB;  // Dirty bands are pages of the image
+    uint8_t TXBUF[129];  // Control byte and one page row of data
+
+    // A flush is queued on the bus as one transaction per page, or per run
+    // of pages sent in vertical addressing, so other devices can go in
+    // between. Each starts with its window commands, if any, then the data.
+    uint16_t STREAM[8 * (16 + 129)];
+    uint16_t STREAM_LENGTH;
+    I2CTransaction FLUSH[8];
+    uint8_t FLUSH_COUNT;  // Queued by the last showAsync
+    uint8_t FLUSH_WINDOW[8][4];  // First and last page and column of each transaction
+    int8_t VERTICAL;  // Addressing mode the SSD1306 is in, -1 when not known
 
     void init();
+    void clearUnusedPages();
+    void clearColumns(uint8_t x0, uint8_t x1);
     void write_cmd(uint8_t cmd);
+    void write_cmds(const uint8_t* cmds, uint8_t count);
     void write_data(uint8_t data);
-    void swap(uint8_t* x1, uint8_t* x2);
-    bool bitRead(uint8_t character, uint8_t index);
-    void drawPixel(uint8_t x, uint8_t y);
+    void setWindow(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, bool vertical);
+    void beginTransaction(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1);
+    uint16_t* streamWords(uint16_t count);
+    void streamCommands(const uint8_t* cmds, uint8_t count);
+    void setRemap();
+    void dirtyColumns(uint8_t* x0, uint8_t* x1);
+    void copyPage(uint8_t page, uint8_t x0, uint8_t x1, uint8_t* out);
 
    public:
     OLED(uint8_t scl,
@@ -72,13 +93,25 @@ class OLED {
          uint8_t width,
          uint8_t height,
          uint32_t freq,
-         i2c_inst_t* i2c);
+         i2c_inst_t* i2c,
+         uint8_t controller = OLED_SSD1306);
     ~OLED();
     void show();
+    void showAsync();
+    void wait();
+    void reset();
+    uint32_t setFrequency(uint32_t freq);
+    bool verifyBus();
     void clear();
+    void clearRegion(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+    void invertRegion(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
     void isDisplay(bool inverse);
     void isInverse(bool inverse);
     void setContrast(uint8_t contrast);
+    void setRotation(uint8_t rotation);
+    void setShift(int8_t steps);
+    uint8_t getWidth();
+    uint8_t getHeight();
 
     void drawFastHLine(uint8_t x, uint8_t y, uint8_t width);
     void drawFastVLine(uint8_t x, uint8_t y, uint8_t height);
@@ -94,8 +127,10 @@ class OLED {
     void setScrollDir(bool direction);
     void isScroll(bool isEnable);
     void setFont(const GFXfont* font);
+    const GFXfont* getFont();
     void printChar(uint8_t x, uint8_t y, uint8_t character);
     void print(uint8_t x, uint8_t y, uint8_t* string);
+    void drawColumns(uint8_t x, uint8_t page, uint8_t width, const uint8_t* columns);
     void drawBitmap(uint8_t x,
                     uint8_t y,
                     uint8_t width,
@@ -0,0 +1,228 @@
+#include "SSD1322.h"
+#include "Dialog_bold_16.h"
+
+void SSD1322::write_cmd(uint8_t cmd, const uint8_t* args, uint8_t count) {
+    // D/C low for the command, high for its arguments
+    gpio_put(CS_PIN, 0);
+    gpio_put(DC_PIN, 0);
+    spi_write_blocking(SPI_PORT, &cmd, 1);
+    if (count) {
+        gpio_put(DC_PIN, 1);
+        spi_write_blocking(SPI_PORT, args, count);
+    }
+    gpio_put(CS_PIN, 1);
+}
+
+void SSD1322::init() {
+    static const struct {
+        uint8_t cmd;
+        uint8_t count;
+        uint8_t args[2];
+    } sequence[] = {
+        {SSD1322_SET_LOCK, 1, {0x12}},             // Unlock the commands
+        {SSD1322_SET_DISP, 0, {}},                 // Display off
+        {SSD1322_SET_CLK_DIV, 1, {0x91}},
+        {SSD1322_SET_MUX_RATIO, 1, {SSD1322_HEIGHT - 1}},
+        {SSD1322_SET_DISP_OFFSET, 1, {0x00}},
+        {SSD1322_SET_START_LINE, 1, {0x00}},
+        {SSD1322_SET_REMAP, 2, {0x14, 0x11}},      // Horizontal increment, left pixel in the high nibble, dual COM
+        {SSD1322_SET_GPIO, 1, {0x00}},
+        {SSD1322_SET_FUNC_SEL, 1, {0x01}},         // Internal VDD regulator
+        {SSD1322_SET_ENHANCE_A, 2, {0xA0, 0xFD}},
+        {SSD1322_SET_CONTRAST, 1, {0x9F}},
+        {SSD1322_SET_MASTER_CONTRAST, 1, {0x0F}},
+        {SSD1322_DEFAULT_GRAY, 0, {}},             // Linear gray scale
+        {SSD1322_SET_PHASE_LEN, 1, {0xE2}},
+        {SSD1322_SET_ENHANCE_B, 2, {0x82, 0x20}},
+        {SSD1322_SET_PRECHARGE, 1, {0x1F}},
+        {SSD1322_SET_PRECHARGE2, 1, {0x08}},
+        {SSD1322_SET_VCOMH, 1, {0x07}},
+        {SSD1322_NORMAL_DISP, 0, {}},
+        {SSD1322_EXIT_PARTIAL, 0, {}},
+    };
+    for (const auto& step : sequence)
+        write_cmd(step.cmd, step.args, step.count);
+    clearRam();  // Also the columns beside the image and the rows below it
+    isDisplay(true);
+}
+
+void SSD1322::clearRam() {
+    static const uint8_t zeros[SSD1322_WIDTH / 2] = {};
+    setWindow(0, SSD1322_RAM_ROWS - 1, 0, SSD1322_WIDTH / SSD1322_COL_GROUP - 1);
+    gpio_put(CS_PIN, 0);
+    gpio_put(DC_PIN, 1);
+    for (uint8_t row = 0; row < SSD1322_RAM_ROWS; row++)
+        spi_write_blocking(SPI_PORT, zeros, sizeof(zeros));
+    gpio_put(CS_PIN, 1);
+}
+
+SSD1322::SSD1322(uint8_t sck,
+                 uint8_t mosi,
+                 uint8_t cs,
+                 uint8_t dc,
+                 uint8_t rst,
+                 uint32_t freq,
+                 spi_inst_t* spi,
+                 uint16_t width) {
+    SPI_PORT = spi;
+    CS_PIN = cs, DC_PIN = dc, RST_PIN = rst;
+    width = (width > SSD1322_WIDTH) ? SSD1322_WIDTH : width & ~(SSD1322_COL_GROUP - 1);
+    FIRST_GROUP = (SSD1322_WIDTH - width) / 2 / SSD1322_COL_GROUP;
+    FB.init(width, SSD1322_HEIGHT, &Dialog_bold_16);
+
+    spi_init(SPI_PORT, freq);
+    gpio_set_function(sck, GPIO_FUNC_SPI);
+    gpio_set_function(mosi, GPIO_FUNC_SPI);
+    uint8_t pins[] = {CS_PIN, DC_PIN, RST_PIN};
+    for (uint8_t pin : pins) {
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_OUT);
+        gpio_put(pin, 1);
+    }
+    // Hardware reset
+    gpio_put(RST_PIN, 0);
+    sleep_ms(1);
+    gpio_put(RST_PIN, 1);
+    sleep_ms(1);
+    init();
+}
+
+void SSD1322::isDisplay(bool display) {
+    write_cmd(SSD1322_SET_DISP | display, nullptr, 0);
+}
+
+void SSD1322::setContrast(uint8_t contrast) {
+    write_cmd(SSD1322_SET_CONTRAST, &contrast, 1);
+}
+
+// Moves the image by rows, as OLED::setShift() on a short panel; the RAM has
+// 128 rows, so the rows moved in are blank, see clearRam()
+void SSD1322::setShift(int8_t rows) {
+    uint8_t offset = (SSD1322_RAM_ROWS + rows % SSD1322_RAM_ROWS) % SSD1322_RAM_ROWS;
+    write_cmd(SSD1322_SET_DISP_OFFSET, &offset, 1);
+}
+
+uint16_t SSD1322::getWidth() {
+    return FB.WIDTH;
+}
+
+uint8_t SSD1322::getHeight() {
+    return FB.HEIGHT;
+}
+
+void SSD1322::setLevel(uint8_t level) {
+    FB.LEVEL = (level > Gray4RowMajor::MAX_LEVEL) ? Gray4RowMajor::MAX_LEVEL : level;
+}
+
+// Addresses the column groups group0 to group1 of the rows row0 to row1
+void SSD1322::setWindow(uint16_t row0, uint16_t row1, uint8_t group0, uint8_t group1) {
+    uint8_t columns[] = {(uint8_t)(SSD1322_COL_OFFSET + FIRST_GROUP + group0),
+                         (uint8_t)(SSD1322_COL_OFFSET + FIRST_GROUP + group1)};
+    uint8_t rows[] = {(uint8_t)row0, (uint8_t)row1};
+    write_cmd(SSD1322_SET_COL_ADDR, columns, 2);
+    write_cmd(SSD1322_SET_ROW_ADDR, rows, 2);
+    write_cmd(SSD1322_WRITE_RAM, nullptr, 0);
+}
+
+void __not_in_flash("ssd1322") SSD1322::show() {
+    // Rows are bands of the row-major buffer. A column address covers 4
+    // pixels, 2 bytes, so the changed columns are widened to whole groups.
+    // Following rows with the same groups share one window and one transfer.
+    const uint16_t row_bytes = FB.WIDTH / 2;
+    for (uint16_t row = 0; row < SSD1322_HEIGHT;) {
+        if (!FB.isDirty(row)) {
+            row++;
+            continue;
+        }
+        uint8_t group0 = FB.DIRTY_X0[row] / SSD1322_COL_GROUP, group1 = FB.DIRTY_X1[row] / SSD1322_COL_GROUP;
+        uint16_t last = row;
+        while (last + 1 < SSD1322_HEIGHT && FB.isDirty(last + 1) &&
+               FB.DIRTY_X0[last + 1] / SSD1322_COL_GROUP == group0 && FB.DIRTY_X1[last + 1] / SSD1322_COL_GROUP == group1)
+            last++;
+        setWindow(row, last, group0, group1);
+        uint16_t bytes = (group1 - group0 + 1) * SSD1322_COL_GROUP / 2;
+        gpio_put(CS_PIN, 0);
+        gpio_put(DC_PIN, 1);
+        if (group0 == 0 && group1 == FB.WIDTH / SSD1322_COL_GROUP - 1) {
+            // Whole rows are consecutive in the buffer
+            spi_write_blocking(SPI_PORT, FB.DATA + row * row_bytes, (last - row + 1) * row_bytes);
+        }
+        else {
+            for (uint16_t r = row; r <= last; r++)
+                spi_write_blocking(SPI_PORT, FB.DATA + r * row_bytes + group0 * SSD1322_COL_GROUP / 2, bytes);
+        }
+        gpio_put(CS_PIN, 1);
+        for (; row <= last; row++)
+            FB.markClean(row);
+    }
+}
+
+void SSD1322::showAsync() {
+    show();
+}
+
+void SSD1322::wait() {}
+
+void SSD1322::clear() {
+    FB.clear();
+}
+
+void __not_in_flash("ssd1322") SSD1322::clearRegion(int16_t x, int16_t y, uint16_t width, uint16_t height) {
+    FB.fillRect(x, y, width, height, 0);
+}
+
+void SSD1322::invertRegion(int16_t x, int16_t y, uint16_t width, uint16_t height) {
+    FB.invertRect(x, y, width, height);
+}
+
+void SSD1322::drawFastHLine(int16_t x, int16_t y, uint16_t width) {
+    FB.fillRect(x, y, width, 1, FB.LEVEL);
+}
+
+void SSD1322::drawFastVLine(int16_t x, int16_t y, uint16_t height) {
+    FB.fillRect(x, y, 1, height, FB.LEVEL);
+}
+
+void SSD1322::drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+    FB.drawLine(x1, y1, x2, y2);
+}
+
+void SSD1322::drawRectangle(int16_t x, int16_t y, uint16_t width, uint16_t height) {
+    FB.drawRectangle(x, y, width, height);
+}
+
+void SSD1322::drawFilledRectangle(int16_t x, int16_t y, uint16_t width, uint16_t height) {
+    FB.fillRect(x, y, width, height, FB.LEVEL);
+}
+
+void SSD1322::drawCircle(int16_t xc, int16_t yc, uint16_t r) {
+    FB.drawCircle(xc, yc, r);
+}
+
+void SSD1322::drawFilledCircle(int16_t xc, int16_t yc, uint16_t r) {
+    FB.drawFilledCircle(xc, yc, r);
+}
+
+void SSD1322::setFont(const GFXfont* font) {
+    FB.FONT = font;
+}
+
+const GFXfont* SSD1322::getFont() {
+    return FB.FONT;
+}
+
+void __not_in_flash("ssd1322") SSD1322::printChar(int16_t x, int16_t y, uint8_t character) {
+    FB.drawChar(x, y, character);
+}
+
+void __not_in_flash("ssd1322") SSD1322::print(int16_t x, int16_t y, uint8_t* string) {
+    FB.print(x, y, (const char*)string);
+}
+
+void __not_in_flash("ssd1322") SSD1322::drawColumns(int16_t x, uint8_t page, uint16_t width, const uint8_t* columns) {
+    FB.drawColumns(x, page, width, columns);
+}
+
+void SSD1322::drawBitmap(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t* image) {
+    FB.drawBitmap(x, y, width, height, image);
+}
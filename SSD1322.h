@@ -0,0 +1,99 @@
+#ifndef _SSD1322_H_
+#define _SSD1322_H_
+
+#include "hardware/spi.h"
+#include "pico/stdlib.h"
+#include "framebuffer.h"
+
+// 256x64 grayscale OLED with 4 bits per pixel, over 4-wire SPI.
+// show() sends the changed column groups of each changed row. The image
+// can be narrower than the panel, e.g. the 128x64 screens of the clock,
+// and is then centred. The drawing functions are the ones of OLED, so the
+// screens draw on either, see display.h.
+
+#define SSD1322_WIDTH 256
+#define SSD1322_HEIGHT 64
+#define SSD1322_RAM_ROWS 128   // The display offset counts over these
+#define SSD1322_COL_OFFSET 0x1C  // Address of the first visible column group
+#define SSD1322_COL_GROUP 4      // Pixels per column address
+
+#define SSD1322_SET_COL_ADDR 0x15
+#define SSD1322_WRITE_RAM 0x5C
+#define SSD1322_SET_ROW_ADDR 0x75
+#define SSD1322_SET_REMAP 0xA0
+#define SSD1322_SET_START_LINE 0xA1
+#define SSD1322_SET_DISP_OFFSET 0xA2
+#define SSD1322_NORMAL_DISP 0xA6
+#define SSD1322_EXIT_PARTIAL 0xA9
+#define SSD1322_SET_FUNC_SEL 0xAB
+#define SSD1322_SET_DISP 0xAE
+#define SSD1322_SET_PHASE_LEN 0xB1
+#define SSD1322_SET_CLK_DIV 0xB3
+#define SSD1322_SET_ENHANCE_A 0xB4
+#define SSD1322_SET_GPIO 0xB5
+#define SSD1322_SET_PRECHARGE2 0xB6
+#define SSD1322_DEFAULT_GRAY 0xB9
+#define SSD1322_SET_PRECHARGE 0xBB
+#define SSD1322_SET_VCOMH 0xBE
+#define SSD1322_SET_CONTRAST 0xC1
+#define SSD1322_SET_MASTER_CONTRAST 0xC7
+#define SSD1322_SET_MUX_RATIO 0xCA
+#define SSD1322_SET_ENHANCE_B 0xD1
+#define SSD1322_SET_LOCK 0xFD
+
+class SSD1322 {
+   private:
+    spi_inst_t* SPI_PORT;
+    uint8_t CS_PIN;
+    uint8_t DC_PIN;
+    uint8_t RST_PIN;
+    uint8_t FIRST_GROUP;  // Column group of the left edge of the image
+
+    void init();
+    void write_cmd(uint8_t cmd, const uint8_t* args, uint8_t count);
+    void setWindow(uint16_t row0, uint16_t row1, uint8_t group0, uint8_t group1);
+    void clearRam();
+
+   public:
+    Framebuffer<Gray4RowMajor, SSD1322_WIDTH, SSD1322_HEIGHT> FB;
+
+    SSD1322(uint8_t sck,
+            uint8_t mosi,
+            uint8_t cs,
+            uint8_t dc,
+            uint8_t rst,
+            uint32_t freq,
+            spi_inst_t* spi,
+            uint16_t width = SSD1322_WIDTH);
+    void show();
+    // SPI writes block, the image is on the display when show() returns
+    void showAsync();
+    void wait();
+    void isDisplay(bool display);
+    void setContrast(uint8_t contrast);
+    void setShift(int8_t rows);
+    uint16_t getWidth();
+    uint8_t getHeight();
+    // Level of the pixels drawn from now on, 0 to 15
+    void setLevel(uint8_t level);
+
+    void clear();
+    void clearRegion(int16_t x, int16_t y, uint16_t width, uint16_t height);
+    void invertRegion(int16_t x, int16_t y, uint16_t width, uint16_t height);
+    void drawFastHLine(int16_t x, int16_t y, uint16_t width);
+    void drawFastVLine(int16_t x, int16_t y, uint16_t height);
+    void drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+    void drawRectangle(int16_t x, int16_t y, uint16_t width, uint16_t height);
+    void drawFilledRectangle(int16_t x, int16_t y, uint16_t width, uint16_t height);
+    void drawCircle(int16_t xc, int16_t yc, uint16_t r);
+    void drawFilledCircle(int16_t xc, int16_t yc, uint16_t r);
+
+    void setFont(const GFXfont* font);
+    const GFXfont* getFont();
+    void printChar(int16_t x, int16_t y, uint8_t character);
+    void print(int16_t x, int16_t y, uint8_t* string);
+    void drawColumns(int16_t x, uint8_t page, uint16_t width, const uint8_t* columns);
+    void drawBitmap(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t* image);
+};
+
+#endif
@@ -1,10 +1,30 @@
 
 
-#include <stdio.h>
+#include <cstring>
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
+#include "pico/stdio_usb.h"
 #include "hardware/rtc.h"
-#include "OLED.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "display.h"
+#include "calendar.h"
+#include "timezone.h"
+#include "epoch.h"
+#include "settings.h"
+#include "drift.h"
+#include "timeformat.h"
+#include "worldclock.h"
+#include "monthview.h"
+#include "stopwatch.h"
+#include "countdown.h"
+#include "clockface.h"
+#include "analogface.h"
+#include "alwayson.h"
+#include "i2ctune.h"
+#include "serialout.h"
+#include "menu.h"
 
 
 #define HIGH                1
@@ -12,9 +32,29 @@
 
 #define OLED_WIDTH          128
 #define OLED_HEIGHT         64
-#define OLED_FREQ           400000
+#define OLED_FREQ           400000 // Tuned up at startup
 #define OLED_SCL            19
 #define OLED_SDA            18
+#define OLED_CONTROLLER     OLED_SSD1306 // OLED_SH1106 for 1.3" panels
+#define OLED_ROTATION       OLED_ROTATE_0 // OLED_ROTATE_180 for units mounted upside down; the screens are laid out for 128x64, not for 90 or 270
+static_assert(OLED_ROTATION == OLED_ROTATE_0 || OLED_ROTATION == OLED_ROTATE_180,
+              "No screen has a portrait layout");
+
+// 256x64 grayscale SSD1322 on SPI instead, built with DISPLAY_SSD1322; the
+// screens are centred on it
+#define SSD1322_FREQ        10000000
+#define SSD1322_SCK         2
+#define SSD1322_MOSI        3
+#define SSD1322_DC          4
+#define SSD1322_CS          5
+#define SSD1322_RST         6
+
+// Optional second display on the other I2C controller
+#define STATUS_OLED         0 // 1 when it is fitted
+#define STATUS_OLED_WIDTH   128
+#define STATUS_OLED_HEIGHT  32
+#define STATUS_OLED_SCL     17
+#define STATUS_OLED_SDA     16
 
 #define LEFT_BUTTON         28
 #define RIGHT_BUTTON        22
@@ -28,78 +68,80 @@
 #define SET_CLOCK_YEAR      2
 #define SET_CLOCK_MONTH     3
 #define SET_CLOCK_DAY       4
-#define SET_CLOCK_WEEKDAY   5
-#define SET_CLOCK_HOUR      6
-#define SET_CLOCK_MIN       7
-#define SET_CLOCK_SEC       8
-#define SET_CLOCK_FINAL     9
-#define ALARM_MENU          10
-#define DISABLE_ALARM       11
-#define SET_ALARM_HOUR      12
-#define SET_ALARM_MIN       13
-#define SET_ALARM_SEC       14
-#define SET_ALARM_FINAL     15
-#define SLEEP_MODE          16
+#define SET_CLOCK_HOUR      5
+#define SET_CLOCK_MIN       6
+#define SET_CLOCK_SEC       7
+#define SET_CLOCK_FINAL     8
+#define DISABLE_ALARM       9
+#define SET_ALARM_HOUR      10
+#define SET_ALARM_MIN       11
+#define SET_ALARM_SEC       12
+#define SET_ALARM_FINAL     13
+#define SLEEP_MODE          14
+#define WORLD_CLOCK         15
+#define MONTH_VIEW          16
+#define STOPWATCH           17
+#define TIMER               18
+#define NO_MODE             0xFF
 
 #define WAIT_DURATION_MS                20
 #define BUZZER_FREQ                     466 // NOTE_AS4
 #define MAX_ALARM_TIME_SEC              60
 #define SLEEP_MODE_ACTIVATION_TIME_MS   10000
+#define SLEEP_TICK_US                   1000000 // Asleep, Core 1 wakes this often for the drift compensation
+#define LAYOUT_SAVE_DELAY_MS            3000 // The clock layout is saved once it is left alone this long
+#define SLEEP_MODE_ALWAYS_ON            1 // 0 blanks the display in SLEEP MODE
+#define BURN_IN_SHIFT_SEC               180 // The images move by a step this often
+#define XIP_CACHE_STATS                 0 // 1 prints the XIP cache hits and misses every 10 s over USB
+#define LOCAL_TIME_ZONE                 TZ_BERLIN // The RTC runs in UTC
+
+#define RING_ALARM          0
+#define RING_TIMER          1
+
+// Steps the images are moved by, in turn, so that static labels do not burn in; see OLED::setShift()
+static const int8_t burn_in_shifts[] = {0, 1, 2, 1, 0, -1, -2, -1};
+
 
-enum Months {JAN=1, FEB, MAR, APR, MAY, JUN, JUL, AUG, SEP, OCT, NOV, DEC};
-const char weekdays[7][10] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
-const char months[12][4]   = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
-const uint8_t weekday_pixel_offset[7] = {28, 24, 22, 8, 18, 32, 20};
 
 // Global variables reachable by both cores
 bool datetime_set = false;
+bool settings_changed = false; // Saved by Core 1 when it starts
 bool alarm_enabled = false; 
 bool alarm_fired = false;
 uint8_t current_mode = MENU;
-uint8_t menu_index = 0;
+MenuState menu; // Moved through by Core 1, drawn by Core 0
 uint8_t alarm_count = 0;
+uint8_t ring_source = RING_ALARM; // What alarm_fired rings for
+uint8_t timer_minutes = 5;
 uint16_t sleep_mode_count = 0;
+int16_t alarm_offset = 0; // UTC offset the alarm is armed with
+int16_t alarm_utc_minute = 0; // Minute of the UTC day the alarm is armed for
 datetime_t alarm_settime;
 datetime_t set_date;
+int16_t calendar_year;  // Month shown in MONTH_VIEW
+uint8_t calendar_month;
 
 datetime_t alarmtime = {
     .year  = -1, // doesnt matter
     .month = -1, // doesnt matter
     .day   = -1, // doesnt matter
     .dotw  = -1, // doesnt matter
-    .hour  =  8, // The alarm fires whenever hour, min, and sec match with those of the current time
+    .hour  =  8, // The alarm fires whenever hour, min, and sec match with those of the current local time
     .min   = 00,
     .sec   = 00
 };
 
+// Local time
 datetime_t date = {
     .year  = 2022,
     .month = 07,
     .day   = 01,
-    .dotw  = 5,
+    .dotw  = day_of_week(2022, 07, 01),
     .hour  = 00,
     .min   = 00,
     .sec   = 00
 };
 
-// 0 <= year <= 4095
-// 1 <= month <= 12 
-// Returns the number of days on given month in given year
-uint8_t number_of_days(uint16_t year, uint8_t month) {
-    if (month==JAN || month==MAR || month==MAY || month==JUL || month==AUG || month==OCT || month==DEC)
-        return 31;
-    else if (month==APR || month==JUN || month==SEP || month==NOV) // the month must be FEB if this is false
-        return 30;
-    else if (year%400==0)
-        return 29;
-    else if (year%100==0)
-        return 28;
-    else if (year%4==0)
-        return 29;
-    else
-        return 28;
-}
-
 // One period of sound at the given frequency from the buzzer
 // If the frequency is zero, then it does nothing
 void buzz(uint64_t freq) {
@@ -110,12 +152,14 @@ void buzz(uint64_t freq) {
     busy_wait_us((uint64_t)500000/freq);
 }
 
-// The function that is called when the alarm is fired
+// Rings for the RTC alarm or the countdown timer, from their interrupts on Core 1
 // It waits user to press a button 
 // If any button is not pressed for 1 min, then alarm is stopped
-static void alarm_callback() {
+static void ring(uint8_t source) {
     gpio_put(LED, HIGH);
+    ring_source = source;
     alarm_fired = true;
+    __sev(); // Wake Core 0 if it waits in SLEEP MODE
     uint64_t start = time_us_64();
     uint64_t duration_us = MAX_ALARM_TIME_SEC*1000000;
     uint64_t end = start + duration_us;
@@ -129,6 +173,136 @@ static void alarm_callback() {
     busy_wait_ms(WAIT_DURATION_MS); // Wait a bit to prevent the button from bouncing
 }
 
+// The function that is called when the alarm is fired
+static void alarm_callback() {
+    ring(RING_ALARM);
+}
+
+// The function that is called when the countdown timer expires
+static void timer_callback() {
+    ring(RING_TIMER);
+}
+
+// Set by the button interrupt of Core 1, cleared when SLEEP MODE starts
+static volatile bool button_pressed = false;
+static uint sleep_alarm; // Hardware alarm that ends the waits of Core 1 in SLEEP MODE
+
+static void button_irq(uint gpio, uint32_t events) {
+    button_pressed = true;
+}
+
+static void sleep_alarm_irq(uint num) {}
+
+// Waits in SLEEP MODE until a button is pressed, the alarm or the timer
+// rings, or SLEEP_TICK_US pass. Only interrupts of Core 1 end the wait and
+// no event is sent, unlike sleep_ms(), so Core 0 sleeps on.
+static void wait_asleep() {
+    hardware_alarm_set_target(sleep_alarm, make_timeout_time_us(SLEEP_TICK_US));
+    // A press just before the wait would not end it, so it is checked with the interrupts off
+    uint32_t status = save_and_disable_interrupts();
+    if (!button_pressed)
+        __wfi();
+    restore_interrupts(status);
+    hardware_alarm_cancel(sleep_alarm);
+}
+
+// Alarm time is local, but the RTC alarm matches the UTC time of the RTC
+// It is armed with the current UTC offset and armed again when the offset changes
+void arm_alarm() {
+    datetime_t now;
+    rtc_get_datetime(&now);
+    alarm_offset = tz_offset(LOCAL_TIME_ZONE, &now);
+    int16_t minute = alarmtime.hour*60 + alarmtime.min - alarm_offset;
+    minute = (minute<0)?minute+1440:(minute>=1440)?minute-1440:minute;
+    datetime_t utc_alarmtime = alarmtime;
+    utc_alarmtime.hour = minute/60;
+    utc_alarmtime.min = minute%60;
+    alarm_utc_minute = minute;
+    rtc_set_alarm(&utc_alarmtime, &alarm_callback);
+}
+
+// Returns whether the alarm fires in this or the next minute
+// The RTC is not stepped then, since a step could skip the second it fires on
+bool alarm_due_soon(const datetime_t *now) {
+    if (!alarm_enabled)
+        return false;
+    epoch_us_t minute = epoch_floor(datetime_to_epoch_us(*now), US_PER_MIN) * US_PER_MIN;
+    return epoch_next_at(minute - 1, alarm_utc_minute*60) - minute <= US_PER_MIN;
+}
+
+// Actions of the menu items, run by Core 1
+static void open_clock() {
+    current_mode = CLOCK;
+}
+
+static void open_set_clock() {
+    datetime_t now;
+    rtc_get_datetime(&now);
+    tz_utc_to_local(LOCAL_TIME_ZONE, &now, &set_date);
+    current_mode = SET_CLOCK_YEAR;
+}
+
+static void toggle_alarm() {
+    if (alarm_enabled)
+        rtc_disable_alarm();
+    else
+        arm_alarm();
+    alarm_enabled = !alarm_enabled;
+    current_mode = DISABLE_ALARM;
+}
+
+static void open_set_alarm() {
+    alarm_settime = alarmtime;
+    current_mode = SET_ALARM_HOUR;
+}
+
+static void open_world_clock() {
+    current_mode = WORLD_CLOCK;
+}
+
+static void open_calendar() {
+    datetime_t now, local;
+    rtc_get_datetime(&now);
+    tz_utc_to_local(LOCAL_TIME_ZONE, &now, &local);
+    calendar_year = local.year;
+    calendar_month = local.month;
+    current_mode = MONTH_VIEW;
+}
+
+static void open_stopwatch() {
+    current_mode = STOPWATCH;
+}
+
+static void open_timer() {
+    current_mode = TIMER;
+}
+
+static bool alarm_is_enabled() {
+    return alarm_enabled;
+}
+
+// The labels are drawn when the firmware is compiled
+static constexpr MenuLabel clock_label("CLOCK"), set_clock_label("SET CLOCK"), alarm_label("ALARM"),
+    world_label("WORLD"), calendar_label("CALENDAR"), stopwatch_label("STOPWATCH"), timer_label("TIMER"),
+    enable_label("ENABLE"), disable_label("DISABLE"), set_label("SET");
+
+static constexpr MenuItem alarm_items[] = {
+    {&enable_label, &disable_label, alarm_is_enabled, nullptr, toggle_alarm},
+    {&set_label, nullptr, nullptr, nullptr, open_set_alarm},
+};
+static constexpr Menu alarm_menu = {alarm_items, sizeof(alarm_items)/sizeof(alarm_items[0])};
+
+static constexpr MenuItem main_items[] = {
+    {&clock_label, nullptr, nullptr, nullptr, open_clock},
+    {&set_clock_label, nullptr, nullptr, nullptr, open_set_clock},
+    {&alarm_label, nullptr, nullptr, &alarm_menu, nullptr},
+    {&world_label, nullptr, nullptr, nullptr, open_world_clock},
+    {&calendar_label, nullptr, nullptr, nullptr, open_calendar},
+    {&stopwatch_label, nullptr, nullptr, nullptr, open_stopwatch},
+    {&timer_label, nullptr, nullptr, nullptr, open_timer},
+};
+static constexpr Menu main_menu = {main_items, sizeof(main_items)/sizeof(main_items[0])};
+
 // Core 1 Main
 // Handles inputs given via buttons
 // Sets and fires alarms
@@ -155,52 +329,96 @@ void core1_main() {
     gpio_set_dir(PICO_DEFAULT_LED_PIN, GPIO_OUT);
     gpio_put(PICO_DEFAULT_LED_PIN, HIGH);
 
+    // In SLEEP MODE a press ends the wait of the core, see wait_asleep()
+    gpio_set_irq_enabled_with_callback(LEFT_BUTTON, GPIO_IRQ_EDGE_RISE, true, &button_irq);
+    gpio_set_irq_enabled(RIGHT_BUTTON, GPIO_IRQ_EDGE_RISE, true);
+    gpio_set_irq_enabled(BACK_BUTTON, GPIO_IRQ_EDGE_RISE, true);
+    gpio_set_irq_enabled(SELECT_BUTTON, GPIO_IRQ_EDGE_RISE, true);
+    sleep_alarm = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(sleep_alarm, sleep_alarm_irq);
+
+    drift_init();
+    if (settings_changed)
+        settings_save();
+    countdown_init(timer_callback);
+
+    // The clock layout was changed and is not saved yet
+    bool layout_unsaved = false;
+
     // Core 1 Main Loop
     while (true) {
+        datetime_t now;
+        rtc_get_datetime(&now);
+        // Follow DST transitions so that the alarm keeps firing at the same local time
+        if (alarm_enabled && tz_offset(LOCAL_TIME_ZONE, &now) != alarm_offset)
+            arm_alarm();
+        if (serial_host_connected())
+            i2c_tune_report();
+        epoch_poll();
+        // Calibrate against the host and compensate the RTC drift
+        drift_poll_host();
+        drift_compensate(!alarm_due_soon(&now));
+
         if (current_mode == CLOCK) {
             if (gpio_get(BACK_BUTTON)) {
                 while (gpio_get(BACK_BUTTON)); // wait button to be released
                 sleep_mode_count = 0; // reset sleep count
+                if (layout_unsaved)
+                    settings_save();
+                layout_unsaved = false;
                 current_mode = MENU;
             }
+            else if (gpio_get(LEFT_BUTTON) || gpio_get(RIGHT_BUTTON)) {
+                // Switch between the clock layouts and the analog faces
+                bool left = gpio_get(LEFT_BUTTON);
+                while (gpio_get(LEFT_BUTTON) || gpio_get(RIGHT_BUTTON));
+                sleep_mode_count = 0;
+                if (left)
+                    settings.clock_layout = (settings.clock_layout==0)?CLOCK_FACE_COUNT-1:settings.clock_layout-1;
+                else
+                    settings.clock_layout = (settings.clock_layout==CLOCK_FACE_COUNT-1)?0:settings.clock_layout+1;
+                layout_unsaved = true;
+            }
             // if there is no activity for a while, then activate sleep mode
             sleep_mode_count++;
+            // Saving erases a flash sector and pauses Core 0, so it waits until the choice settles
+            if (layout_unsaved && sleep_mode_count==LAYOUT_SAVE_DELAY_MS/WAIT_DURATION_MS) {
+                settings_save();
+                layout_unsaved = false;
+            }
             if (sleep_mode_count==SLEEP_MODE_ACTIVATION_TIME_MS/WAIT_DURATION_MS) {
                 sleep_mode_count = 0;
+                button_pressed = false;
                 current_mode = SLEEP_MODE;
             }
         }
         else if (current_mode == SLEEP_MODE) {
-            while (!gpio_get(SELECT_BUTTON) && !gpio_get(BACK_BUTTON) && \
-                     !gpio_get(LEFT_BUTTON) && !gpio_get(RIGHT_BUTTON)) {
-                        busy_wait_ms(WAIT_DURATION_MS);
+            // Checked once per loop, so that the calibration keeps running while asleep
+            // A press seen by the interrupt counts too, it may be over by now
+            if (button_pressed || gpio_get(SELECT_BUTTON) || gpio_get(BACK_BUTTON) || \
+                gpio_get(LEFT_BUTTON) || gpio_get(RIGHT_BUTTON)) {
+                while (gpio_get(SELECT_BUTTON) || gpio_get(BACK_BUTTON) || \
+                         gpio_get(LEFT_BUTTON) || gpio_get(RIGHT_BUTTON));  // Wait buttons to be released
+                current_mode = CLOCK; // After the button is released, go back to CLOCK mode
+                __sev(); // Wake Core 0
             }
-            while (gpio_get(SELECT_BUTTON) || gpio_get(BACK_BUTTON) || \
-                     gpio_get(LEFT_BUTTON) || gpio_get(RIGHT_BUTTON));  // Wait buttons to be released
-            current_mode = CLOCK; // After the button is released, go back to CLOCK mode
         }
         else if (current_mode == MENU) {
             if (gpio_get(LEFT_BUTTON)) {
                 while (gpio_get(LEFT_BUTTON));
-                menu_index = (menu_index==0)?2:menu_index-1;
+                menu_previous(&menu);
             }
             else if (gpio_get(RIGHT_BUTTON)) {
                 while (gpio_get(RIGHT_BUTTON));
-                menu_index = (menu_index==2)?0:menu_index+1;
+                menu_next(&menu);
             }
             else if (gpio_get(SELECT_BUTTON)) {
                 while (gpio_get(SELECT_BUTTON));
-                if (menu_index == 0) {
-                    current_mode = CLOCK;
-                }
-                else if (menu_index == 1) {
-                    current_mode = SET_CLOCK_YEAR;
-                    rtc_get_datetime(&set_date);
-                }
-                else if (menu_index == 2) {
-                    current_mode = ALARM_MENU;
-                }
-                menu_index = 0; 
+                menu_select(&menu);
+            }
+            else if (gpio_get(BACK_BUTTON)) {
+                while (gpio_get(BACK_BUTTON));
+                menu_back(&menu);
             }
         }
         else if (current_mode == SET_CLOCK_YEAR) {
@@ -233,7 +451,7 @@ void core1_main() {
             else if (gpio_get(SELECT_BUTTON)) {
                 while (gpio_get(SELECT_BUTTON));
                 // The number of days in a month depends on the month and the year
-                uint8_t day_num = number_of_days(set_date.year, set_date.month);
+                uint8_t day_num = days_in_month(set_date.year, set_date.month);
                 set_date.day = (set_date.day>day_num)?day_num:set_date.day;
                 current_mode = SET_CLOCK_DAY;
             }
@@ -243,7 +461,7 @@ void core1_main() {
             }
         }
         else if (current_mode == SET_CLOCK_DAY) {
-            uint8_t day_num = number_of_days(set_date.year, set_date.month);
+            uint8_t day_num = days_in_month(set_date.year, set_date.month);
             if (gpio_get(LEFT_BUTTON)) {
                 while (gpio_get(LEFT_BUTTON));
                 set_date.day = (set_date.day==1)?day_num:set_date.day-1;
@@ -252,31 +470,13 @@ void core1_main() {
                 while (gpio_get(RIGHT_BUTTON));
                 set_date.day = (set_date.day==day_num)?1:set_date.day+1;
             }
-            else if (gpio_get(SELECT_BUTTON)) {
-                while (gpio_get(SELECT_BUTTON));
-                current_mode = SET_CLOCK_WEEKDAY;
-            }
-            else if (gpio_get(BACK_BUTTON)) {
-                while (gpio_get(BACK_BUTTON));
-                current_mode = SET_CLOCK_MONTH;
-            }
-        }
-        else if (current_mode == SET_CLOCK_WEEKDAY) {
-            if (gpio_get(LEFT_BUTTON)) {
-                while (gpio_get(LEFT_BUTTON));
-                set_date.dotw = (set_date.dotw==0)?6:set_date.dotw-1;
-            }
-            else if (gpio_get(RIGHT_BUTTON)) {
-                while (gpio_get(RIGHT_BUTTON));
-                set_date.dotw = (set_date.dotw==6)?0:set_date.dotw+1;
-            }
             else if (gpio_get(SELECT_BUTTON)) {
                 while (gpio_get(SELECT_BUTTON));
                 current_mode = SET_CLOCK_HOUR;
             }
             else if (gpio_get(BACK_BUTTON)) {
                 while (gpio_get(BACK_BUTTON));
-                current_mode = SET_CLOCK_DAY;
+                current_mode = SET_CLOCK_MONTH;
             }
         }
         else if (current_mode == SET_CLOCK_HOUR) {
@@ -294,7 +494,7 @@ void core1_main() {
             }
             else if (gpio_get(BACK_BUTTON)) {
                 while (gpio_get(BACK_BUTTON));
-                current_mode = SET_CLOCK_WEEKDAY;
+                current_mode = SET_CLOCK_DAY;
             }
         }
         else if (current_mode == SET_CLOCK_MIN) {
@@ -326,7 +526,11 @@ void core1_main() {
             }
             else if (gpio_get(SELECT_BUTTON)) {
                 while (gpio_get(SELECT_BUTTON));
-                datetime_set = rtc_set_datetime(&set_date);
+                // The weekday follows from the date, so it is never entered by hand
+                set_date.dotw = day_of_week(set_date.year, set_date.month, set_date.day);
+                datetime_t utc;
+                tz_local_to_utc(LOCAL_TIME_ZONE, &set_date, &utc);
+                datetime_set = rtc_set_datetime(&utc);
                 current_mode = SET_CLOCK_FINAL;
             }
             else if (gpio_get(BACK_BUTTON)) {
@@ -334,37 +538,6 @@ void core1_main() {
                 current_mode = SET_CLOCK_MIN;
             }
         }
-        else if (current_mode == ALARM_MENU) {
-            if (gpio_get(LEFT_BUTTON)) {
-                while (gpio_get(LEFT_BUTTON));
-                menu_index = (menu_index==0)?1:0;
-            }
-            else if (gpio_get(RIGHT_BUTTON)) {
-                while (gpio_get(RIGHT_BUTTON));
-                menu_index = (menu_index==1)?0:1;
-            }
-            else if (gpio_get(SELECT_BUTTON)) {
-                while (gpio_get(SELECT_BUTTON));
-                if (menu_index == 0) {
-                    if (alarm_enabled)
-                        rtc_disable_alarm();
-                    else
-                        rtc_set_alarm(&alarmtime, &alarm_callback);
-                    alarm_enabled = !alarm_enabled;
-                    current_mode = DISABLE_ALARM;
-                }
-                else if (menu_index == 1) {
-                    current_mode = SET_ALARM_HOUR;
-                    alarm_settime = alarmtime;
-                }
-                menu_index = 0;
-            }
-            else if (gpio_get(BACK_BUTTON)) {
-                while (gpio_get(BACK_BUTTON));
-                current_mode = MENU;
-                menu_index = 0;
-            }
-        }
         else if (current_mode == SET_ALARM_HOUR) {
             if (gpio_get(LEFT_BUTTON)) {
                 while (gpio_get(LEFT_BUTTON));
@@ -413,7 +586,7 @@ void core1_main() {
             else if (gpio_get(SELECT_BUTTON)) {
                 while (gpio_get(SELECT_BUTTON));
                 alarmtime = alarm_settime;
-                rtc_set_alarm(&alarmtime, &alarm_callback);
+                arm_alarm();
                 alarm_enabled = true;
                 current_mode = SET_ALARM_FINAL;
             }
@@ -422,6 +595,76 @@ void core1_main() {
                 current_mode = SET_ALARM_MIN;
             }
         }
+        else if (current_mode == WORLD_CLOCK) {
+            if (gpio_get(BACK_BUTTON)) {
+                while (gpio_get(BACK_BUTTON));
+                current_mode = MENU;
+            }
+        }
+        else if (current_mode == MONTH_VIEW) {
+            if (gpio_get(LEFT_BUTTON)) {
+                while (gpio_get(LEFT_BUTTON));
+                if (calendar_month > 1)
+                    calendar_month--;
+                else if (calendar_year > CALENDAR_MIN_YEAR)
+                    calendar_year--, calendar_month = 12;
+            }
+            else if (gpio_get(RIGHT_BUTTON)) {
+                while (gpio_get(RIGHT_BUTTON));
+                if (calendar_month < 12)
+                    calendar_month++;
+                else if (calendar_year < CALENDAR_MAX_YEAR)
+                    calendar_year++, calendar_month = 1;
+            }
+            else if (gpio_get(BACK_BUTTON)) {
+                while (gpio_get(BACK_BUTTON));
+                current_mode = MENU;
+            }
+        }
+        else if (current_mode == STOPWATCH) {
+            // The time is taken when the press is seen, not when the button is released
+            // The stopwatch keeps running when the screen is left
+            if (gpio_get(SELECT_BUTTON)) {
+                stopwatch_start_stop(time_us_64());
+                while (gpio_get(SELECT_BUTTON));
+            }
+            else if (gpio_get(RIGHT_BUTTON)) {
+                stopwatch_lap(time_us_64());
+                while (gpio_get(RIGHT_BUTTON));
+            }
+            else if (gpio_get(LEFT_BUTTON)) {
+                while (gpio_get(LEFT_BUTTON));
+                stopwatch_reset();
+            }
+            else if (gpio_get(BACK_BUTTON)) {
+                while (gpio_get(BACK_BUTTON));
+                current_mode = MENU;
+            }
+        }
+        else if (current_mode == TIMER) {
+            // The timer keeps running when the screen is left and rings from any mode
+            if (gpio_get(LEFT_BUTTON)) {
+                while (gpio_get(LEFT_BUTTON));
+                if (!countdown_running())
+                    timer_minutes = (timer_minutes==1)?COUNTDOWN_MAX_MIN:timer_minutes-1;
+            }
+            else if (gpio_get(RIGHT_BUTTON)) {
+                while (gpio_get(RIGHT_BUTTON));
+                if (!countdown_running())
+                    timer_minutes = (timer_minutes==COUNTDOWN_MAX_MIN)?1:timer_minutes+1;
+            }
+            else if (gpio_get(SELECT_BUTTON)) {
+                while (gpio_get(SELECT_BUTTON));
+                if (countdown_running())
+                    countdown_cancel();
+                else
+                    countdown_start(timer_minutes*60);
+            }
+            else if (gpio_get(BACK_BUTTON)) {
+                while (gpio_get(BACK_BUTTON));
+                current_mode = MENU;
+            }
+        }
         else if (current_mode == SET_ALARM_FINAL || \
                  current_mode == SET_CLOCK_FINAL || \
                  current_mode == DISABLE_ALARM) {
@@ -430,36 +673,125 @@ void core1_main() {
                 current_mode = CLOCK;
             }
         }
-        busy_wait_ms(WAIT_DURATION_MS); // to prevent buttons from bouncing
+        // Wait to prevent buttons from bouncing
+        // Asleep, the core waits for an interrupt in low power instead, but
+        // not while a USB host may send sync lines, which are timed
+        if (current_mode == SLEEP_MODE && !stdio_usb_connected())
+            wait_asleep();
+        else
+            busy_wait_ms(WAIT_DURATION_MS);
     } // end of while loop
 }
 
+// Returns true with the steps to move the images by when the next burn-in shift is due
+static bool burn_in_due(int8_t* steps) {
+    static uint64_t next_us = BURN_IN_SHIFT_SEC*1000000ull;
+    static uint8_t index = 0;
+    if (time_us_64() < next_us)
+        return false;
+    next_us += BURN_IN_SHIFT_SEC*1000000ull;
+    index = (index + 1) % (sizeof(burn_in_shifts)/sizeof(burn_in_shifts[0]));
+    *steps = burn_in_shifts[index];
+    return true;
+}
+
 // Core 0 Main
 // Renders texts for the display
 int main() {
-    // Initialise and clear the OLED display
-    OLED oled(OLED_SCL, OLED_SDA, OLED_WIDTH, OLED_HEIGHT, OLED_FREQ, i2c1);
+    stdio_init_all();
+    settings_load();
+    if (settings.clock_layout >= CLOCK_FACE_COUNT)
+        settings.clock_layout = 0;
+    multicore_lockout_victim_init(); // Core 1 pauses Core 0 while it writes the settings
+
+    // Initialise and clear the display
+#if DISPLAY_SSD1322
+    Display oled(SSD1322_SCK, SSD1322_MOSI, SSD1322_CS, SSD1322_DC, SSD1322_RST, SSD1322_FREQ, spi0, OLED_WIDTH);
+    oled.clear();
+    oled.show();
+#else
+    Display oled(OLED_SCL, OLED_SDA, OLED_WIDTH, OLED_HEIGHT, OLED_FREQ, i2c1, OLED_CONTROLLER);
+    oled.setRotation(OLED_ROTATION);
     oled.clear();
     oled.show();
+    uint32_t freq = i2c_tune(oled, OLED_FREQ, settings.i2c_freq);
+    if (freq != settings.i2c_freq) {
+        settings.i2c_freq = freq;
+        settings_changed = true;
+    }
+#endif
+#if STATUS_OLED
+    OLED status_oled(STATUS_OLED_SCL, STATUS_OLED_SDA, STATUS_OLED_WIDTH, STATUS_OLED_HEIGHT, OLED_FREQ, i2c0);
+    status_oled.show();
+#endif
 
     // Start RTC
     rtc_init();
-    rtc_set_datetime(&date);
+    epoch_init();
+    stopwatch_init();
+    datetime_t utc;
+    tz_local_to_utc(LOCAL_TIME_ZONE, &date, &utc);
+    rtc_set_datetime(&utc);
 
-    // Start Core 1
+    // Start Core 1 with the top menu open
+    menu_open(&menu, &main_menu);
     multicore_launch_core1(core1_main);
 
     // Create a buffer to print string to OLED display
     char oled_str[30];
 
+    // The mode drawn by the previous frame
+    uint8_t drawn_mode = NO_MODE;
+    // The month drawn in MONTH_VIEW, as year*12 + month with the highlighted day
+    int32_t drawn_month = -1;
+    uint8_t drawn_today = 0;
+    // The clock layout or analog face drawn in CLOCK
+    uint8_t drawn_face = 0;
+
     // Core 0 Main Loop
     while (true) {
-        oled.clear();
+#if XIP_CACHE_STATS
+        // Of both cores; writing the counters clears them
+        static uint64_t stats_us = 0;
+        if (time_us_64() - stats_us >= 10000000) {
+            uint32_t hits = xip_ctrl_hw->ctr_hit, accesses = xip_ctrl_hw->ctr_acc;
+            xip_ctrl_hw->ctr_hit = 0;
+            xip_ctrl_hw->ctr_acc = 0;
+            serial_print("xip cache ");
+            serial_print_number(hits);
+            serial_print(" hits, ");
+            serial_print_number(accesses - hits);
+            serial_print(" misses\n");
+            stats_us = time_us_64();
+        }
+#endif
+        int8_t shift;
+        if (burn_in_due(&shift)) {
+            oled.setShift(shift);
+#if STATUS_OLED
+            status_oled.setShift(shift);
+#endif
+        }
+        // Read once, Core 1 may change it while the frame is drawn
+        uint8_t mode = current_mode;
+        bool redraw = alarm_fired || mode != drawn_mode;
+        drawn_mode = alarm_fired ? NO_MODE : mode;
+        // Screens that only redraw what changes keep the buffer between frames
+        bool partial = (mode == CLOCK || mode == WORLD_CLOCK || mode == MONTH_VIEW || mode == STOPWATCH);
+        if (alarm_fired || !partial)
+            oled.clear();
         if (alarm_fired) { // Display alarm message
             if (alarm_count < 8) { // When alarm fires, the alarm message flicks
-                oled.print(32, 8, (uint8_t *)"ALARM");
-                sprintf(oled_str, "%02hi:%02hi:%02hi", (uint16_t)alarmtime.hour, (uint16_t)alarmtime.min, (uint16_t)alarmtime.sec);
-                oled.print(20, 32, (uint8_t *)oled_str);
+                if (ring_source == RING_TIMER) {
+                    oled.print(32, 8, (uint8_t *)"TIMER");
+                    strcpy(format_number(oled_str, timer_minutes, 2), ":00");
+                    oled.print(34, 32, (uint8_t *)oled_str);
+                }
+                else {
+                    oled.print(32, 8, (uint8_t *)"ALARM");
+                    format_time(clock_layouts[0].time, &alarmtime, oled_str); // HH:MM:SS
+                    oled.print(20, 32, (uint8_t *)oled_str);
+                }
                 alarm_count++;
             }
             else {
@@ -469,82 +801,99 @@ int main() {
                 continue;
             }
         }
-        else if (current_mode == MENU) {
-            oled.print(8, 0, (uint8_t *)"CLOCK");
-            oled.print(8, 20, (uint8_t *)"SET CLOCK");
-            oled.print(8, 40, (uint8_t *)"ALARM");
-            oled.print(0, 20*menu_index, (uint8_t *)"-");
-        }
-        else if (current_mode == ALARM_MENU) {
-            if (alarm_enabled)
-                oled.print(8, 0, (uint8_t *)"DISABLE");
-            else 
-                oled.print(8, 0, (uint8_t *)"ENABLE");
-            oled.print(8, 20, (uint8_t *)"SET");
-            oled.print(0, 20*menu_index, (uint8_t *)"-");
+        else if (mode == MENU) {
+            draw_menu(oled, &menu);
         }
-        else if (current_mode == DISABLE_ALARM) {
+        else if (mode == DISABLE_ALARM) {
             oled.print(12, 8, (uint8_t *)"ALARM IS");
             if (alarm_enabled)
                 oled.print(14, 32, (uint8_t *)"ENABLED");
             else
                 oled.print(12, 32, (uint8_t *)"DISABLED");
         }
-        else if (current_mode == CLOCK) {
-            bool rtc_running = rtc_get_datetime(&date);
-            if (rtc_running) {
-                sprintf(oled_str, "%02hi %s %04hi", (uint16_t)date.day, months[date.month-1], date.year);
-                oled.print(2, 0, (uint8_t *)oled_str);
-                sprintf(oled_str, "%02hi:%02hi:%02hi", (uint16_t)date.hour, (uint16_t)date.min, (uint16_t)date.sec);
-                oled.print(16, 20, (uint8_t *)oled_str);
-                sprintf(oled_str, "%s", weekdays[date.dotw]);
-                oled.print(weekday_pixel_offset[date.dotw], 40, (uint8_t *)oled_str);
+        else if (mode == CLOCK) {
+            uint8_t face = settings.clock_layout;
+            redraw = redraw || face != drawn_face;
+            drawn_face = face;
+            if (face >= CLOCK_FACE_ANALOG) {
+                draw_analog_face(oled, LOCAL_TIME_ZONE, face == CLOCK_FACE_ANALOG_SWEEP, redraw);
             }
             else {
-                oled.print(24, 8, (uint8_t *)"RTC NOT");
-                oled.print(24, 32, (uint8_t *)"WORKING");
+                int32_t alarm_second = alarm_enabled ? alarm_utc_minute*60 + alarmtime.sec : -1;
+                draw_clock_face(oled, LOCAL_TIME_ZONE, alarm_second, redraw);
             }
         }
-        else if (current_mode == SLEEP_MODE) {
-            oled.show(); // Blank display
+        else if (mode == TIMER) {
+            uint32_t remaining = countdown_running() ? countdown_remaining_sec() : timer_minutes*60;
+            oled.print(32, 8, (uint8_t *)"TIMER");
+            char* end = format_number(oled_str, remaining/60, 2);
+            *end++ = ':';
+            format_number(end, remaining%60, 2);
+            oled.print(34, 32, (uint8_t *)oled_str);
+        }
+        else if (mode == SLEEP_MODE) {
+#if SLEEP_MODE_ALWAYS_ON
+            oled.setContrast(0);
+            uint32_t wait_us = draw_always_on(oled, LOCAL_TIME_ZONE, true);
+#else
+            uint32_t wait_us = 60000000; // Blank, nothing to draw until Core 1 signals
+#endif
+            oled.show();
             while (current_mode == SLEEP_MODE && !alarm_fired) { // Wait until Core 1 changes the current mode or alarm fires
-                tight_loop_contents();
-            }
+#if STATUS_OLED
+                draw_status_panel(status_oled, LOCAL_TIME_ZONE, alarm_enabled ? alarm_utc_minute*60 + alarmtime.sec : -1);
+                status_oled.showAsync();
+                wait_us = (wait_us < 1000000) ? wait_us : 1000000; // Once a second for the status panel
+#endif
+                // The core sleeps until the next minute, or until Core 1 signals
+                absolute_time_t until = make_timeout_time_us(wait_us);
+                while (current_mode == SLEEP_MODE && !alarm_fired && !best_effort_wfe_or_timeout(until));
+                // The always-on face is the one most at risk of burning in
+                if (burn_in_due(&shift)) {
+                    oled.setShift(shift);
+#if STATUS_OLED
+                    status_oled.setShift(shift);
+#endif
+                }
+#if SLEEP_MODE_ALWAYS_ON
+                wait_us = draw_always_on(oled, LOCAL_TIME_ZONE, false);
+                oled.showAsync(); // Nothing is sent unless a digit changed
+#endif
+            }
+#if SLEEP_MODE_ALWAYS_ON
+            oled.setContrast(0xFF);
+#endif
             continue;
         }
-        else if (SET_CLOCK_YEAR <= current_mode && current_mode <= SET_CLOCK_SEC) {
-            switch (current_mode) {
+        else if (SET_CLOCK_YEAR <= mode && mode <= SET_CLOCK_SEC) {
+            switch (mode) {
                 case SET_CLOCK_YEAR:
-                    sprintf(oled_str, "%04hi", set_date.year);
+                    format_number(oled_str, set_date.year, 4);
                     oled.print(8, 8, (uint8_t *)"YEAR");
                     break;
                 case SET_CLOCK_MONTH:
-                    sprintf(oled_str, "%s", months[set_date.month-1]);
+                    strcpy(oled_str, months[set_date.month-1]);
                     oled.print(8, 8, (uint8_t *)"MONTH");
                     break;
                 case SET_CLOCK_DAY:
-                    sprintf(oled_str, "%02hi", (uint16_t)set_date.day);
+                    format_number(oled_str, set_date.day, 2);
                     oled.print(8, 8, (uint8_t *)"DAY");
                     break;
-                case SET_CLOCK_WEEKDAY:
-                    sprintf(oled_str, "%s", weekdays[set_date.dotw]);
-                    oled.print(8, 8, (uint8_t *)"WEEKDAY");
-                    break;
                 case SET_CLOCK_HOUR:
-                    sprintf(oled_str, "%02hi", (uint16_t)set_date.hour);
+                    format_number(oled_str, set_date.hour, 2);
                     oled.print(8, 8, (uint8_t *)"HOUR");
                     break;
                 case SET_CLOCK_MIN:
-                    sprintf(oled_str, "%02hi", (uint16_t)set_date.min);
+                    format_number(oled_str, set_date.min, 2);
                     oled.print(8, 8, (uint8_t *)"MIN");
                     break;
                 case SET_CLOCK_SEC:
-                    sprintf(oled_str, "%02hi", (uint16_t)set_date.sec);
+                    format_number(oled_str, set_date.sec, 2);
                     oled.print(8, 8, (uint8_t *)"SEC");
             }
             oled.print(8, 28, (uint8_t *)oled_str);
         }
-        else if (current_mode == SET_CLOCK_FINAL) {
+        else if (mode == SET_CLOCK_FINAL) {
             if (datetime_set) {
                 oled.print(30, 8, (uint8_t *)"CLOCK");
                 oled.print(30, 32, (uint8_t *)"IS SET");
@@ -554,27 +903,51 @@ int main() {
                 oled.print(24, 32, (uint8_t *)"DATE");
             }
         }
-        else if (SET_ALARM_HOUR <= current_mode && current_mode <= SET_ALARM_SEC) {
-            switch (current_mode) {
+        else if (SET_ALARM_HOUR <= mode && mode <= SET_ALARM_SEC) {
+            switch (mode) {
                 case SET_ALARM_HOUR:
-                    sprintf(oled_str, "%02hi", (uint16_t)alarm_settime.hour);
+                    format_number(oled_str, alarm_settime.hour, 2);
                     oled.print(0, 8, (uint8_t *)"ALARM HOUR");
                     break;
                 case SET_ALARM_MIN:
-                    sprintf(oled_str, "%02hi", (uint16_t)alarm_settime.min);
+                    format_number(oled_str, alarm_settime.min, 2);
                     oled.print(0, 8, (uint8_t *)"ALARM MIN");
                     break;
                 case SET_ALARM_SEC:
-                    sprintf(oled_str, "%02hi", (uint16_t)alarm_settime.sec);
+                    format_number(oled_str, alarm_settime.sec, 2);
                     oled.print(0, 8, (uint8_t *)"ALARM SEC");
             }
             oled.print(0, 28, (uint8_t *)oled_str);
         }
-        else if (current_mode == SET_ALARM_FINAL) {
+        else if (mode == WORLD_CLOCK) {
+            draw_world_clock(oled, LOCAL_TIME_ZONE, redraw);
+        }
+        else if (mode == MONTH_VIEW) {
+            int16_t year = calendar_year;
+            uint8_t month = calendar_month;
+            datetime_t utc;
+            rtc_get_datetime(&utc);
+            tz_utc_to_local(LOCAL_TIME_ZONE, &utc, &date);
+            uint8_t today = (date.year == year && date.month == month) ? date.day : 0;
+            if (redraw || drawn_month != year*12 + month || drawn_today != today) {
+                draw_month_view(oled, year, month, today);
+                drawn_month = year*12 + month;
+                drawn_today = today;
+            }
+        }
+        else if (mode == STOPWATCH) {
+            draw_stopwatch(oled, redraw);
+        }
+        else if (mode == SET_ALARM_FINAL) {
             oled.print(30, 8, (uint8_t *)"ALARM");
             oled.print(30, 32, (uint8_t *)"IS SET");
         }
-        oled.show();
+#if STATUS_OLED
+        draw_status_panel(status_oled, LOCAL_TIME_ZONE, alarm_enabled ? alarm_utc_minute*60 + alarmtime.sec : -1);
+        status_oled.showAsync();
+#endif
+        // Both displays are sent by DMA at the same time while the next frame is drawn
+        oled.showAsync();
     } // end of while loop
 }
 
@@ -0,0 +1,70 @@
+#include "hardware/rtc.h"
+#include "alwayson.h"
+#include "timezone.h"
+
+#define DIGIT_WIDTH 22
+#define DIGIT_HEIGHT 40
+#define STROKE 2
+#define DIGIT_GAP 4
+#define COLON_WIDTH 12
+#define FACE_WIDTH (4 * DIGIT_WIDTH + 2 * DIGIT_GAP + COLON_WIDTH)
+
+struct Segment {
+    uint8_t x, y, width, height;
+};
+
+// a to g: top, upper right, lower right, bottom, lower left, upper left, middle
+static const Segment segments[7] = {
+    {STROKE, 0, DIGIT_WIDTH - 2 * STROKE, STROKE},
+    {DIGIT_WIDTH - STROKE, STROKE, STROKE, DIGIT_HEIGHT / 2 - STROKE},
+    {DIGIT_WIDTH - STROKE, DIGIT_HEIGHT / 2, STROKE, DIGIT_HEIGHT / 2 - STROKE},
+    {STROKE, DIGIT_HEIGHT - STROKE, DIGIT_WIDTH - 2 * STROKE, STROKE},
+    {0, DIGIT_HEIGHT / 2, STROKE, DIGIT_HEIGHT / 2 - STROKE},
+    {0, STROKE, STROKE, DIGIT_HEIGHT / 2 - STROKE},
+    {STROKE, DIGIT_HEIGHT / 2 - STROKE / 2, DIGIT_WIDTH - 2 * STROKE, STROKE},
+};
+
+// Segments lit for each digit, bit 0 is a
+static const uint8_t digit_segments[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+
+// Left edge of each digit from the left of the face
+static const uint8_t digit_x[4] = {0, DIGIT_WIDTH + DIGIT_GAP, 2 * DIGIT_WIDTH + DIGIT_GAP + COLON_WIDTH,
+                                   3 * DIGIT_WIDTH + 2 * DIGIT_GAP + COLON_WIDTH};
+
+static int8_t shown[4];
+
+static void draw_digit(Display& oled, uint8_t x, uint8_t y, uint8_t digit) {
+    oled.clearRegion(x, y, DIGIT_WIDTH, DIGIT_HEIGHT);
+    for (uint8_t i = 0; i < 7; i++)
+        if (digit_segments[digit] & (1 << i))
+            oled.drawFilledRectangle(x + segments[i].x, y + segments[i].y, segments[i].width, segments[i].height);
+}
+
+uint32_t draw_always_on(Display& oled, uint8_t local_zone, bool redraw) {
+    datetime_t utc, local;
+    if (!rtc_get_datetime(&utc))
+        return 1000000;
+    tz_utc_to_local(local_zone, &utc, &local);
+
+    uint8_t x = (oled.getWidth() - FACE_WIDTH) / 2;
+    uint8_t y = (oled.getHeight() - DIGIT_HEIGHT) / 2;
+    if (redraw) {
+        oled.clear();
+        uint8_t colon = x + 2 * DIGIT_WIDTH + DIGIT_GAP + (COLON_WIDTH - STROKE) / 2;
+        oled.drawFilledRectangle(colon, y + DIGIT_HEIGHT / 3 - STROKE / 2, STROKE, STROKE);
+        oled.drawFilledRectangle(colon, y + 2 * DIGIT_HEIGHT / 3 - STROKE / 2, STROKE, STROKE);
+        for (uint8_t i = 0; i < 4; i++)
+            shown[i] = -1;
+    }
+    int8_t digits[4] = {(int8_t)(local.hour / 10), (int8_t)(local.hour % 10), (int8_t)(local.min / 10),
+                        (int8_t)(local.min % 10)};
+    for (uint8_t i = 0; i < 4; i++) {
+        if (digits[i] == shown[i])
+            continue;
+        draw_digit(oled, x + digit_x[i], y, digits[i]);
+        shown[i] = digits[i];
+    }
+    // The RTC second started up to a second ago, so the wake up is as late
+    // in the new minute as this call is in the current second
+    return (60 - utc.sec) * 1000000u;
+}
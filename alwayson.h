@@ -0,0 +1,14 @@
+#ifndef _ALWAYSON_H_
+#define _ALWAYSON_H_
+
+#include "display.h"
+
+// Always-on face for SLEEP MODE: HH:MM in large seven-segment digits with
+// thin strokes, so few pixels are lit, shown at the lowest contrast. Only
+// the digits that changed are redrawn, so a minute is one small flush.
+
+// Draws the local time if its minute changed; redraw draws the whole screen.
+// Returns the microseconds until the next minute is due.
+uint32_t draw_always_on(Display& oled, uint8_t local_zone, bool redraw);
+
+#endif
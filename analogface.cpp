@@ -0,0 +1,168 @@
+#include "hardware/rtc.h"
+#include "analogface.h"
+#include "timezone.h"
+
+#define DIAL_SIZE 64
+#define CENTER 31       // Of the dial, in its buffer
+#define DIAL_RADIUS 31
+#define HOUR_TICK 5     // Tick length at the hours, 2 elsewhere
+#define HANDS 3
+
+static const uint8_t hand_lengths[HANDS] = {15, 23, 27};  // Hour, minute, second
+
+// sin(2 pi i / 60) in Q15; the cosine is the entry 15 ticks later
+struct SineTable {
+    int16_t value[60];
+
+    constexpr SineTable() : value{} {
+        for (uint8_t i = 0; i < 60; i++) {
+            // Taylor series on -pi to pi
+            double x = 2 * 3.14159265358979323846 * ((i < 30) ? i : i - 60) / 60;
+            double term = x, sum = x;
+            for (uint8_t n = 1; n < 12; n++) {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            double q15 = sum * 32767;
+            value[i] = (int16_t)((q15 < 0) ? q15 - 0.5 : q15 + 0.5);
+        }
+    }
+};
+
+static constexpr SineTable sine;
+static_assert(sine.value[0] == 0 && sine.value[15] == 32767 && sine.value[30] == 0 && sine.value[45] == -32767,
+              "sine table must be exact at the quarters");
+
+struct Box {
+    int16_t x0, y0, x1, y1;
+};
+
+static Framebuffer<Mono1PageMajor, DIAL_SIZE, DIAL_SIZE> dial;
+static bool dial_ready = false;
+static int16_t shown_x[HANDS], shown_y[HANDS];  // Ends of the hands on the screen
+static int8_t shown_sec = -1;
+static uint64_t second_start_us;  // When the RTC second last changed
+static uint64_t frame_us;
+static bool rtc_failed = false;
+
+// Interpolates the table between two ticks, fraction is in 1/256 of a tick
+static int32_t sine_at(uint8_t tick, int32_t fraction) {
+    int32_t a = sine.value[tick % 60], b = sine.value[(tick + 1) % 60];
+    return a + (((b - a) * fraction) >> 8);
+}
+
+// End of a hand of the given length at position / 256 ticks, clockwise from 12
+static void hand_end(uint16_t position, uint8_t length, int16_t* x, int16_t* y) {
+    uint8_t tick = (position >> 8) % 60;
+    int32_t fraction = position & 0xFF;
+    *x = CENTER + ((length * sine_at(tick, fraction) + (1 << 14)) >> 15);
+    *y = CENTER - ((length * sine_at(tick + 15, fraction) + (1 << 14)) >> 15);
+}
+
+static Box hand_box(int16_t x, int16_t y) {
+    Box box = {CENTER, CENTER, CENTER, CENTER};
+    if (x < CENTER)
+        box.x0 = x;
+    else
+        box.x1 = x;
+    if (y < CENTER)
+        box.y0 = y;
+    else
+        box.y1 = y;
+    return box;
+}
+
+static bool overlap(const Box& a, const Box& b) {
+    return a.x0 <= b.x1 && b.x0 <= a.x1 && a.y0 <= b.y1 && b.y0 <= a.y1;
+}
+
+static void draw_dial() {
+    dial.init(DIAL_SIZE, DIAL_SIZE, nullptr);
+    dial.drawCircle(CENTER, CENTER, DIAL_RADIUS);
+    for (uint8_t tick = 0; tick < 60; tick++) {
+        int16_t x0, y0, x1, y1;
+        hand_end(tick << 8, DIAL_RADIUS - ((tick % 5) ? 2 : HOUR_TICK), &x0, &y0);
+        hand_end(tick << 8, DIAL_RADIUS - 1, &x1, &y1);
+        dial.drawLine(x0, y0, x1, y1);
+    }
+    dial.fillRect(CENTER - 1, CENTER - 1, 3, 3, 1);
+}
+
+// Puts the dial back in a box of it. dial_y is on a page boundary, so the
+// pages of the dial are copied as they are.
+static void restore(Display& oled, int16_t dial_x, int16_t dial_y, const Box& box) {
+    uint8_t width = box.x1 - box.x0 + 1;
+    oled.clearRegion(dial_x + box.x0, dial_y + box.y0, width, box.y1 - box.y0 + 1);
+    for (uint8_t page = box.y0 / 8; page <= box.y1 / 8; page++)
+        oled.drawColumns(dial_x + box.x0, dial_y / 8 + page, width, dial.DATA + DIAL_SIZE * page + box.x0);
+}
+
+void draw_analog_face(Display& oled, uint8_t local_zone, bool sweep, bool redraw) {
+    datetime_t utc, local;
+    if (!rtc_get_datetime(&utc)) {
+        if (redraw || !rtc_failed) {
+            oled.clear();
+            oled.print(24, 8, (uint8_t *)"RTC NOT");
+            oled.print(24, 32, (uint8_t *)"WORKING");
+            rtc_failed = true;
+        }
+        return;
+    }
+    redraw = redraw || rtc_failed;
+    rtc_failed = false;
+
+    uint64_t now_us = time_us_64();
+    bool new_second = utc.sec != shown_sec;
+    if (new_second) {
+        second_start_us = now_us;
+        shown_sec = utc.sec;
+    }
+    if (!redraw && !(sweep ? now_us - frame_us >= ANALOG_FRAME_US : new_second))
+        return;
+    frame_us = now_us;
+    tz_utc_to_local(local_zone, &utc, &local);
+
+    int16_t dial_x = (oled.getWidth() - DIAL_SIZE) / 2;
+    int16_t dial_y = ((oled.getHeight() - DIAL_SIZE) / 2) & ~7;
+    if (redraw) {
+        if (!dial_ready) {
+            draw_dial();
+            dial_ready = true;
+        }
+        oled.clear();
+        for (uint8_t page = 0; page < DIAL_SIZE / 8; page++)
+            oled.drawColumns(dial_x, dial_y / 8 + page, DIAL_SIZE, dial.DATA + DIAL_SIZE * page);
+    }
+
+    uint32_t fraction = sweep ? (now_us - second_start_us) * 256 / 1000000 : 0;
+    if (fraction > 255)
+        fraction = 255;
+    uint16_t positions[HANDS] = {
+        (uint16_t)(((local.hour % 12) * 60 + local.min) * 256 / 12),
+        (uint16_t)((local.min * 60 + local.sec) * 256 / 60),
+        (uint16_t)(local.sec * 256 + fraction),
+    };
+    int16_t x[HANDS], y[HANDS];
+    bool draw[HANDS];
+    for (uint8_t i = 0; i < HANDS; i++) {
+        hand_end(positions[i], hand_lengths[i], &x[i], &y[i]);
+        draw[i] = redraw || x[i] != shown_x[i] || y[i] != shown_y[i];
+    }
+    // The dial is put back under the hands that moved, which may also erase
+    // parts of the hands that did not
+    if (!redraw)
+        for (uint8_t i = 0; i < HANDS; i++) {
+            if (x[i] == shown_x[i] && y[i] == shown_y[i])
+                continue;
+            Box box = hand_box(shown_x[i], shown_y[i]);
+            restore(oled, dial_x, dial_y, box);
+            for (uint8_t j = 0; j < HANDS; j++)
+                draw[j] = draw[j] || overlap(box, hand_box(shown_x[j], shown_y[j]));
+        }
+    for (uint8_t i = 0; i < HANDS; i++) {
+        if (!draw[i])
+            continue;
+        oled.drawLine(dial_x + CENTER, dial_y + CENTER, dial_x + x[i], dial_y + y[i]);
+        shown_x[i] = x[i], shown_y[i] = y[i];
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef _ANALOGFACE_H_
+#define _ANALOGFACE_H_
+
+#include "display.h"
+#include "timeformat.h"
+
+// Analog clock faces, chosen with LEFT and RIGHT after the digital layouts.
+// The hands are placed with a Q15 sine table of the 60 tick positions, made
+// at compile time, and drawn with integer lines. The dial is drawn once into
+// a buffer of its own; a frame only restores the dial under the hands that
+// moved and draws the hands again.
+
+#define CLOCK_FACE_ANALOG       CLOCK_LAYOUT_COUNT        // Ticking second hand
+#define CLOCK_FACE_ANALOG_SWEEP (CLOCK_LAYOUT_COUNT + 1)  // Sweeping second hand
+#define CLOCK_FACE_COUNT        (CLOCK_LAYOUT_COUNT + 2)
+
+#define ANALOG_FRAME_US 33333  // 30 frames per second while sweeping
+
+// Draws the dial at the centre of the screen and the hands for the local
+// time. Ticking only draws when the second changes. The sweep is timed
+// with the microsecond timer from the last change of the RTC second.
+// redraw draws the whole screen.
+void draw_analog_face(Display& oled, uint8_t local_zone, bool sweep, bool redraw);
+
+#endif
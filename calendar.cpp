@@ -0,0 +1,55 @@
+#include "calendar.h"
+
+// Walks every day of the years in [first, last] and checks that the day
+// count, its inverse and the weekday all advance by exactly one day
+constexpr bool calendar_check_days(int32_t first, int32_t last) {
+    int32_t expected = days_from_civil(first, 1, 1);
+    uint8_t weekday = day_of_week(expected);
+    for (int32_t year = first; year <= last; year++) {
+        for (uint8_t month = 1; month <= 12; month++) {
+            const uint8_t count = days_in_month(year, month);
+            for (uint8_t day = 1; day <= count; day++) {
+                if (days_from_civil(year, month, day) != expected)
+                    return false;
+                const civil_date date = civil_from_days(expected);
+                if (date.year != year || date.month != month || date.day != day)
+                    return false;
+                if (day_of_week(expected) != weekday)
+                    return false;
+                expected++;
+                weekday = (weekday == 6) ? 0 : weekday + 1;
+            }
+        }
+    }
+    return true;
+}
+
+// Checks the first and the last day of every month in [first, last]
+constexpr bool calendar_check_months(int32_t first, int32_t last) {
+    int32_t expected = days_from_civil(first, 1, 1);
+    for (int32_t year = first; year <= last; year++) {
+        for (uint8_t month = 1; month <= 12; month++) {
+            const uint8_t count = days_in_month(year, month);
+            if (days_from_civil(year, month, 1) != expected)
+                return false;
+            const civil_date head = civil_from_days(expected);
+            const civil_date tail = civil_from_days(expected + count - 1);
+            if (head.year != year || head.month != month || head.day != 1 ||
+                tail.year != year || tail.month != month || tail.day != count)
+                return false;
+            expected += count;
+        }
+    }
+    return true;
+}
+
+// Evaluated once here rather than in every file including calendar.h.
+// The conversions only depend on the position inside a 400-year era, so
+// every day of one era plus every month boundary of the RTC range covers
+// all 0..4095 dates
+static_assert(days_from_civil(1970, 1, 1) == 0, "epoch must be day 0");
+static_assert(day_of_week(2022, 7, 1) == 5, "2022-07-01 was a Friday");
+static_assert(calendar_check_days(1600, 1799), "calendar mismatch in 1600..1799");
+static_assert(calendar_check_days(1800, 1999), "calendar mismatch in 1800..1999");
+static_assert(calendar_check_months(CALENDAR_MIN_YEAR, CALENDAR_MAX_YEAR),
+              "calendar mismatch in the RTC year range");
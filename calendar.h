@@ -0,0 +1,75 @@
+#ifndef _CALENDAR_H_
+#define _CALENDAR_H_
+
+#include <stdint.h>
+
+// Proleptic Gregorian calendar arithmetic over a linear day count.
+// Day 0 is 1970-01-01. Every function is constexpr, so the conversions
+// can be used for tables and checks that are evaluated at compile time.
+// The algorithms follow Howard Hinnant's days_from_civil/civil_from_days:
+// years are shifted to start in March, so that the leap day is the last
+// day of a 400-year era and no per-month branching is needed.
+
+#define CALENDAR_MIN_YEAR 0     // RTC year range
+#define CALENDAR_MAX_YEAR 4095
+
+#define DAYS_PER_ERA 146097     // Days in 400 Gregorian years
+#define EPOCH_DAY_OFFSET 719468 // Days from 0000-03-01 to 1970-01-01
+
+struct civil_date {
+    int16_t year;
+    uint8_t month;  // 1..12
+    uint8_t day;    // 1..31
+};
+
+constexpr bool is_leap_year(int32_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// 1 <= month <= 12
+// Returns the number of days on given month in given year
+constexpr uint8_t days_in_month(int32_t year, uint8_t month) {
+    return (month == 2) ? (is_leap_year(year) ? 29 : 28)
+                        : 30 + ((month + (month >> 3)) & 1);
+}
+
+// Returns the number of days since 1970-01-01 for the given date
+constexpr int32_t days_from_civil(int32_t year, uint8_t month, uint8_t day) {
+    year -= (month <= 2);
+    const int32_t era = (year >= 0 ? year : year - 399) / 400;
+    const uint32_t yoe = (uint32_t)(year - era * 400);                       // [0, 399]
+    const uint32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;  // [0, 365]
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;             // [0, 146096]
+    return era * DAYS_PER_ERA + (int32_t)doe - EPOCH_DAY_OFFSET;
+}
+
+// Inverse of days_from_civil
+constexpr civil_date civil_from_days(int32_t days) {
+    days += EPOCH_DAY_OFFSET;
+    const int32_t era = (days >= 0 ? days : days - (DAYS_PER_ERA - 1)) / DAYS_PER_ERA;
+    const uint32_t doe = (uint32_t)(days - era * DAYS_PER_ERA);                   // [0, 146096]
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365]
+    const uint32_t mp = (5 * doy + 2) / 153;                                     // [0, 11]
+    const uint8_t day = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    const uint8_t month = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+    const int32_t year = (int32_t)yoe + era * 400 + (month <= 2);
+    return civil_date{(int16_t)year, month, day};
+}
+
+// 0 is Sunday, as in datetime_t.dotw
+constexpr uint8_t day_of_week(int32_t days) {
+    // 1970-01-01 was a Thursday
+    return (uint8_t)(((days + 4) % 7 + 7) % 7);
+}
+
+constexpr uint8_t day_of_week(int32_t year, uint8_t month, uint8_t day) {
+    return day_of_week(days_from_civil(year, month, day));
+}
+
+// Moves the date by the given number of days, which may be negative
+constexpr civil_date add_days(civil_date date, int32_t days) {
+    return civil_from_days(days_from_civil(date.year, date.month, date.day) + days);
+}
+
+#endif
@@ -0,0 +1,180 @@
+#include <cstring>
+
+#include "hardware/rtc.h"
+#include "clockface.h"
+#include "Compact_5x7.h"
+#include "timezone.h"
+#include "timeformat.h"
+#include "settings.h"
+#include "countdown.h"
+#include "epoch.h"
+
+#define LINES 3
+#define LINE_SPACING 20
+#define LINE_TOP 7      // Rows of a line printed at y in the large font
+#define LINE_HEIGHT 16
+#define STATUS_HEIGHT 7 // Rows 0 to 6, above the first line
+#define ICON_WIDTH 7
+#define STATUS_WIDTH(cells) (ICON_WIDTH + 2 + (cells) * 6)
+#define ALARM_CELLS 10  // IN 23H 59M
+#define ALARM_X 0
+#define TIMER_CELLS 5   // MM:SS
+#define TIMER_X (128 - STATUS_WIDTH(TIMER_CELLS))
+
+static_assert(ALARM_X + STATUS_WIDTH(ALARM_CELLS) < TIMER_X, "status elements must not overlap");
+
+// Icons as page columns, bit 0 is the top row
+static const uint8_t bell_icon[ICON_WIDTH] = {0x20, 0x38, 0x3E, 0x7F, 0x3E, 0x38, 0x20};
+static const uint8_t hourglass_icon[ICON_WIDTH] = {0x00, 0x63, 0x55, 0x49, 0x55, 0x63, 0x00};
+
+struct Line {
+    char text[TIME_FORMAT_MAX_LENGTH];
+    uint8_t x;
+    uint8_t width;
+};
+
+static Line shown[LINES];
+static char shown_alarm[ALARM_CELLS + 1];
+static char shown_timer[TIMER_CELLS + 1];
+static int64_t alarm_status_minute = -1;  // Epoch minute the alarm status was computed in
+static int32_t alarm_status_second = -1;
+static bool rtc_failed = false;
+
+// Replaces the line on the screen if its text changed
+static void draw_line(Display& oled, uint8_t row, const char* text, uint8_t width) {
+    Line& line = shown[row];
+    if (strcmp(line.text, text) == 0)
+        return;
+    uint8_t y = row * LINE_SPACING;
+    oled.clearRegion(line.x, y + LINE_TOP, line.width, LINE_HEIGHT);
+    line.x = (128 - width) / 2;
+    line.width = width;
+    strcpy(line.text, text);
+    oled.print(line.x, y, (uint8_t *)line.text);
+}
+
+// Replaces a status element, an icon followed by compact text, if its text
+// changed. The element has a fixed region, empty text clears it.
+static void draw_status(Display& oled, uint8_t x, uint8_t cells, const uint8_t* icon, const char* text,
+                        char* on_screen) {
+    if (strcmp(text, on_screen) == 0)
+        return;
+    oled.clearRegion(x, 0, STATUS_WIDTH(cells), STATUS_HEIGHT);
+    if (text[0]) {
+        oled.drawColumns(x, 0, ICON_WIDTH, icon);
+        oled.print(x + ICON_WIDTH + 2, 0, (uint8_t *)text);
+    }
+    strcpy(on_screen, text);
+}
+
+static char* put_number(char* out, uint32_t value) {
+    if (value >= 10)
+        *out++ = '0' + value / 10;
+    *out++ = '0' + value % 10;
+    return out;
+}
+
+// Writes the time until the alarm, e.g. "IN 7H 12M"
+// alarm_second is the second of the UTC day the alarm is armed for. The
+// difference is taken between epoch minutes, so it changes exactly on
+// minute boundaries and needs no carrying between the fields.
+static void alarm_status(epoch_us_t now, int32_t alarm_second, char* out) {
+    epoch_us_t alarm = epoch_next_at(now, alarm_second);
+    uint32_t minutes = epoch_floor(alarm, US_PER_MIN) - epoch_floor(now, US_PER_MIN);
+    memcpy(out, "IN ", 3);
+    out = put_number(out + 3, minutes / 60);
+    *out++ = 'H';
+    *out++ = ' ';
+    out = put_number(out, minutes % 60);
+    *out++ = 'M';
+    *out = '\0';
+}
+
+static void timer_status(char* out) {
+    uint32_t remaining = countdown_remaining_sec();
+    if (!countdown_running() || remaining == 0) {
+        out[0] = '\0';
+        return;
+    }
+    out[0] = '0' + remaining / 600;
+    out[1] = '0' + remaining / 60 % 10;
+    out[2] = ':';
+    out[3] = '0' + remaining % 60 / 10;
+    out[4] = '0' + remaining % 10;
+    out[5] = '\0';
+}
+
+void draw_clock_face(Display& oled, uint8_t local_zone, int32_t alarm_second, bool redraw) {
+    datetime_t utc, local;
+    if (!rtc_get_datetime(&utc)) {
+        if (redraw || !rtc_failed) {
+            oled.clear();
+            oled.print(24, 8, (uint8_t *)"RTC NOT");
+            oled.print(24, 32, (uint8_t *)"WORKING");
+            rtc_failed = true;
+        }
+        return;
+    }
+    if (redraw || rtc_failed) {
+        oled.clear();
+        memset(shown, 0, sizeof(shown));
+        shown_alarm[0] = '\0';
+        shown_timer[0] = '\0';
+        alarm_status_minute = -1;
+        rtc_failed = false;
+    }
+    tz_utc_to_local(local_zone, &utc, &local);
+
+    char text[TIME_FORMAT_MAX_LENGTH];
+    const ClockLayout& layout = clock_layouts[settings.clock_layout];
+    uint8_t width = format_time(layout.date, &local, text);
+    draw_line(oled, 0, text, width);
+    width = format_time(layout.time, &local, text);
+    draw_line(oled, 1, text, width);
+    draw_line(oled, 2, weekdays[local.dotw], weekday_width(local.dotw));
+
+    const GFXfont* font = oled.getFont();
+    oled.setFont(&Compact_5x7);
+    char status[ALARM_CELLS + 1];
+    // The alarm status only changes on minute boundaries or when the alarm is changed
+    epoch_us_t now = datetime_to_epoch_us(utc);
+    int64_t minute = epoch_floor(now, US_PER_MIN);
+    if (minute != alarm_status_minute || alarm_second != alarm_status_second) {
+        if (alarm_second >= 0)
+            alarm_status(now, alarm_second, status);
+        else
+            status[0] = '\0';
+        draw_status(oled, ALARM_X, ALARM_CELLS, bell_icon, status, shown_alarm);
+        alarm_status_minute = minute;
+        alarm_status_second = alarm_second;
+    }
+    timer_status(status);
+    draw_status(oled, TIMER_X, TIMER_CELLS, hourglass_icon, status, shown_timer);
+    oled.setFont(font);
+}
+
+void draw_status_panel(OLED& oled, uint8_t local_zone, int32_t alarm_second) {
+    static int8_t shown_sec = -1;
+    datetime_t utc, local;
+    if (!rtc_get_datetime(&utc) || utc.sec == shown_sec)
+        return;
+    shown_sec = utc.sec;
+    tz_utc_to_local(local_zone, &utc, &local);
+
+    // Once a second, a whole redraw is cheap next to the flush
+    oled.clear();
+    char text[TIME_FORMAT_MAX_LENGTH];
+    uint8_t width = format_time(clock_layouts[0].time, &local, text);
+    oled.print((oled.getWidth() - width) / 2, 0, (uint8_t *)text);
+
+    const GFXfont* font = oled.getFont();
+    oled.setFont(&Compact_5x7);
+    uint8_t y = oled.getHeight() - STATUS_HEIGHT;
+    if (alarm_second >= 0) {
+        alarm_status(datetime_to_epoch_us(utc), alarm_second, text);
+        oled.print(0, y, (uint8_t *)text);
+    }
+    timer_status(text);
+    oled.print(oled.getWidth() - TIMER_CELLS * 6, y, (uint8_t *)text);
+    oled.setFont(font);
+}
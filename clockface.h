@@ -0,0 +1,18 @@
+#ifndef _CLOCKFACE_H_
+#define _CLOCKFACE_H_
+
+#include "display.h"
+
+// Draws the CLOCK screen: date, time and weekday in the selected layout,
+// and a status strip in the compact font above them. Each line is redrawn
+// only when its text changes, so a second only flushes the time line.
+// alarm_second is the second of the UTC day the alarm is armed for, or -1
+// when it is disabled; the time until it is shown in the status strip.
+// redraw draws the whole screen, e.g. when the screen is entered.
+void draw_clock_face(Display& oled, uint8_t local_zone, int32_t alarm_second, bool redraw);
+
+// Draws the time and the alarm and timer status on a secondary panel,
+// e.g. 128x32, once a second
+void draw_status_panel(OLED& oled, uint8_t local_zone, int32_t alarm_second);
+
+#endif
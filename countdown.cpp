@@ -0,0 +1,53 @@
+#include "hardware/timer.h"
+#include "pico/sync.h"
+#include "countdown.h"
+
+static uint alarm_num;
+static void (*expired_callback)();
+
+// Set by Core 1 and read by Core 0 for the display
+static critical_section_t countdown_lock;
+static bool running = false;
+static uint64_t end_us = 0;
+
+static void countdown_irq(uint num) {
+    running = false;
+    expired_callback();
+}
+
+void countdown_init(void (*expired)()) {
+    critical_section_init(&countdown_lock);
+    expired_callback = expired;
+    alarm_num = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(alarm_num, countdown_irq);
+}
+
+void countdown_start(uint32_t seconds) {
+    critical_section_enter_blocking(&countdown_lock);
+    end_us = time_us_64() + (uint64_t)seconds * 1000000;
+    running = true;
+    critical_section_exit(&countdown_lock);
+    // The target is in the future unless seconds is 0, then it is due now
+    if (hardware_alarm_set_target(alarm_num, from_us_since_boot(end_us)))
+        countdown_irq(alarm_num);
+}
+
+void countdown_cancel() {
+    hardware_alarm_cancel(alarm_num);
+    running = false;
+}
+
+bool countdown_running() {
+    return running;
+}
+
+uint32_t countdown_remaining_sec() {
+    critical_section_enter_blocking(&countdown_lock);
+    bool active = running;
+    uint64_t end = end_us;
+    critical_section_exit(&countdown_lock);
+    uint64_t now_us = time_us_64();
+    if (!active || now_us >= end)
+        return 0;
+    return (end - now_us + 999999) / 1000000;
+}
@@ -0,0 +1,22 @@
+#ifndef _COUNTDOWN_H_
+#define _COUNTDOWN_H_
+
+#include "pico/stdlib.h"
+
+// Kitchen timer that expires on a hardware timer alarm, so nothing polls
+// it. The alarm interrupt is taken by the core that calls countdown_init(),
+// which is Core 1, the same core that rings the RTC alarm.
+
+#define COUNTDOWN_MAX_MIN 99
+
+// Claims a hardware alarm; expired is called from its interrupt
+void countdown_init(void (*expired)());
+
+void countdown_start(uint32_t seconds);
+void countdown_cancel();
+bool countdown_running();
+
+// Remaining time rounded up to whole seconds, 0 when not running
+uint32_t countdown_remaining_sec();
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef _DISPLAY_H_
+#define _DISPLAY_H_
+
+#include "OLED.h"
+#include "SSD1322.h"
+
+// The main display the screens draw on. Both classes have the same drawing
+// functions; DISPLAY_SSD1322 is set by the build, see CMakeLists.txt.
+#ifndef DISPLAY_SSD1322
+#define DISPLAY_SSD1322 0
+#endif
+
+#if DISPLAY_SSD1322
+typedef SSD1322 Display;
+#else
+typedef OLED Display;
+#endif
+
+#endif
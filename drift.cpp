@@ -0,0 +1,169 @@
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "drift.h"
+#include "settings.h"
+#include "serialout.h"
+
+#define FS_PER_SEC 1000000000000000LL // Unit of the error accumulator: us * ppb
+#define DRIFT_SAVE_THRESHOLD_PPB 50   // Smaller changes are not worth a flash write
+#define DRIFT_STEP_WINDOW_US 900000   // Steps are prepared in the last 100 ms of a second
+#define DRIFT_SAVE_INTERVAL_US (3600 * US_PER_SEC) // The total correction is saved at most this often
+
+static bool reference_set = false;
+static epoch_us_t reference_host_us;
+static uint64_t reference_timer_us;
+static uint64_t last_compensation_us = 0;
+static int64_t pending_fs = 0; // Accumulated error, positive when the RTC is ahead
+static int64_t corrected_fs = 0; // Correction not yet counted in settings.drift_correction
+static uint64_t last_save_us = 0;
+static bool correction_unsaved = false;
+#if DRIFT_TRIM_DIVIDER
+static uint32_t nominal_div;    // clk_rtc divider of the SDK, 8 fractional bits
+static uint32_t applied_div;
+static int64_t dither_error = 0; // Divider steps of 1/65536 times us, positive when the RTC ran fast
+#endif
+
+static char line[24];
+static uint8_t line_length = 0;
+
+static void report(int64_t offset_us) {
+    int32_t ppb = settings.drift_ppb;
+    int32_t ppb_abs = (ppb < 0) ? -ppb : ppb;
+    // e.g. "drift +1.250 ppm, offset -12 us, corrected +3 s"
+    serial_print((ppb < 0) ? "drift -" : "drift +");
+    serial_print_number(ppb_abs / 1000);
+    serial_print(".");
+    serial_print_number(ppb_abs % 1000, 3);
+    serial_print(" ppm, offset ");
+    serial_print_number(offset_us);
+    serial_print(" us, corrected ");
+    serial_print_number(settings.drift_correction, 1, true);
+    serial_print(" s\n");
+}
+
+// Sets the RTC to the host time at the start of the next host second
+static void sync_rtc(epoch_us_t host_us) {
+    uint64_t wait_us = US_PER_SEC - host_us % US_PER_SEC;
+    busy_wait_us(wait_us);
+    datetime_t t = epoch_us_to_datetime(host_us + wait_us);
+    rtc_set_datetime(&t);
+    reference_host_us = host_us + wait_us;
+    reference_timer_us = time_us_64();
+    reference_set = true;
+    pending_fs = 0;
+}
+
+static void handle_sync(epoch_us_t host_us) {
+    uint64_t timer_us = time_us_64();
+    // The first line is also the first time the host can see a report
+    if (!reference_set) {
+        sync_rtc(host_us);
+        report(0);
+        return;
+    }
+    int64_t host_elapsed = host_us - reference_host_us;
+    int64_t local_elapsed = timer_us - reference_timer_us;
+    int64_t offset_us = epoch_now_us() - host_us;
+    if (host_elapsed >= DRIFT_MIN_REFERENCE_SEC * US_PER_SEC) {
+        int32_t ppb = (int32_t)((local_elapsed - host_elapsed) * 1000000000LL / host_elapsed);
+        int32_t change = ppb - settings.drift_ppb;
+        settings.drift_ppb = ppb;
+        if (change >= DRIFT_SAVE_THRESHOLD_PPB || change <= -DRIFT_SAVE_THRESHOLD_PPB)
+            settings_save();
+    }
+    report(offset_us);
+}
+
+void drift_init() {
+    last_compensation_us = time_us_64();
+    last_save_us = last_compensation_us;
+#if DRIFT_TRIM_DIVIDER
+    nominal_div = applied_div = clocks_hw->clk[clk_rtc].div;
+#endif
+}
+
+void drift_poll_host() {
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (c == '\n' || c == '\r') {
+            line[line_length] = '\0';
+            if (line_length > 1 && line[0] == 'T') {
+                epoch_us_t host_us = 0;
+                for (uint8_t i = 1; i < line_length && '0' <= line[i] && line[i] <= '9'; i++)
+                    host_us = host_us * 10 + (line[i] - '0');
+                handle_sync(host_us);
+            }
+            line_length = 0;
+        }
+        else if (line_length < sizeof(line) - 1) {
+            line[line_length++] = c;
+        }
+    }
+}
+
+// Counts the correction in whole seconds and saves it now and then: a save
+// erases a flash sector and pauses Core 0
+static void count_correction(int64_t fs) {
+    corrected_fs += fs;
+    while (corrected_fs >= FS_PER_SEC || corrected_fs <= -FS_PER_SEC) {
+        int8_t second = (corrected_fs > 0) ? 1 : -1;
+        settings.drift_correction += second;
+        corrected_fs -= second * FS_PER_SEC;
+        correction_unsaved = true;
+    }
+    if (correction_unsaved && time_us_64() - last_save_us >= DRIFT_SAVE_INTERVAL_US) {
+        settings_save();
+        correction_unsaved = false;
+        last_save_us = time_us_64();
+    }
+}
+
+#if DRIFT_TRIM_DIVIDER
+void drift_compensate(bool step_allowed) {
+    (void)step_allowed; // The divider never skips a second
+    uint64_t now_us = time_us_64();
+    int64_t elapsed_us = now_us - last_compensation_us;
+    last_compensation_us = now_us;
+    // The divider that cancels the drift, with 16 more fractional bits.
+    // One step of the register, 1/256 of its integer part, is several ppm,
+    // so the two steps around it are taken for the right share of the time.
+    int64_t target = ((int64_t)nominal_div << 16) + (int64_t)settings.drift_ppb * nominal_div * 65536 / 1000000000;
+    dither_error += (target - ((int64_t)applied_div << 16)) * elapsed_us;
+    // Bounded to a second of one step, so a new calibration does not pay
+    // back the error of the old one
+    const int64_t limit = (int64_t)65536 * US_PER_SEC;
+    dither_error = (dither_error > limit) ? limit : (dither_error < -limit) ? -limit : dither_error;
+    uint32_t div = target >> 16;
+    if (dither_error > 0)
+        div++;
+    if (div != applied_div) {
+        clocks_hw->clk[clk_rtc].div = div;
+        applied_div = div;
+    }
+    // A positive drift is corrected by slowing the RTC down, i.e. backwards
+    count_correction(-elapsed_us * settings.drift_ppb);
+}
+#else
+void drift_compensate(bool step_allowed) {
+    uint64_t now_us = time_us_64();
+    pending_fs += (int64_t)(now_us - last_compensation_us) * settings.drift_ppb;
+    last_compensation_us = now_us;
+    if ((pending_fs < FS_PER_SEC && pending_fs > -FS_PER_SEC) || !step_allowed)
+        return;
+    if (epoch_now_us() % US_PER_SEC < DRIFT_STEP_WINDOW_US)
+        return;
+
+    // Wait for the next RTC second, it is only a few ms away
+    datetime_t t, next;
+    rtc_get_datetime(&t);
+    do {
+        rtc_get_datetime(&next);
+    } while (next.sec == t.sec);
+
+    int8_t step = (pending_fs > 0) ? -1 : 1;
+    next = epoch_us_to_datetime(datetime_to_epoch_us(next) + step * US_PER_SEC);
+    rtc_set_datetime(&next);
+    pending_fs += step * FS_PER_SEC;
+    count_correction(step * FS_PER_SEC);
+}
+#endif
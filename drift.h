@@ -0,0 +1,38 @@
+#ifndef _DRIFT_H_
+#define _DRIFT_H_
+
+#include "epoch.h"
+
+// RTC drift calibration against a host clock over USB.
+//
+// The host sends "T<microseconds since epoch>\n" lines, e.g. with
+// tools/rtc_sync.py. The first one sets the RTC and starts a measurement;
+// later ones compare the elapsed host time with the elapsed local time
+// and, once DRIFT_MIN_REFERENCE_SEC have passed, store the drift in ppb.
+// The RTC, the timer and their divider all run from the same crystal,
+// so the elapsed local time is taken from the microsecond timer.
+//
+// The drift is compensated by trimming the clk_rtc divider. One step of its
+// 8-bit fraction is several ppm, so the two steps around the divider
+// that cancels the drift are switched between for the right share of the
+// time, and the RTC stays within a microsecond of the corrected time.
+// With DRIFT_TRIM_DIVIDER at 0, the RTC is stepped by one second whenever
+// the accumulated error reaches a second instead. Steps are written right
+// after an RTC second boundary, so no fraction of a second is lost.
+
+#define DRIFT_MIN_REFERENCE_SEC 600
+#define DRIFT_TRIM_DIVIDER 1
+
+// Restores the calibration from the settings. It is reported with the
+// answer to the first sync line, USB is not connected yet at boot.
+void drift_init();
+
+// Reads pending sync lines from the host without blocking
+void drift_poll_host();
+
+// Trims the RTC divider for the time since the last call, called often,
+// or accumulates the drift and steps the RTC when due. step_allowed is
+// false while a step could make the alarm miss its second.
+void drift_compensate(bool step_allowed);
+
+#endif
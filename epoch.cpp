@@ -0,0 +1,48 @@
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+#include "epoch.h"
+
+#define EPOCH_EDGE_US 50000  // A second seen to start within this is an anchor
+
+// Both cores read the time, the anchor is shared between them
+static critical_section_t epoch_lock;
+static int64_t anchor_sec = -1;  // An RTC second
+static uint64_t anchor_us = 0;   // Timer value at its start
+static int64_t seen_sec = -1;    // RTC second at the last read
+static uint64_t seen_us = 0;     // Timer value of the last read
+
+void epoch_init() {
+    critical_section_init(&epoch_lock);
+}
+
+epoch_us_t epoch_now_us() {
+    datetime_t t;
+    critical_section_enter_blocking(&epoch_lock);
+    rtc_get_datetime(&t);
+    uint64_t now_us = time_us_64();
+    int64_t sec = datetime_to_epoch_sec(t);
+    if (sec != seen_sec) {
+        // The second started between the two reads
+        int64_t expected = anchor_sec + (int64_t)(now_us - anchor_us) / US_PER_SEC;
+        if (now_us - seen_us <= EPOCH_EDGE_US) {
+            anchor_sec = sec;
+            anchor_us = now_us - (now_us - seen_us) / 2;
+        }
+        else if (anchor_sec < 0 || sec > expected + 1 || sec < expected - 1) {
+            // The RTC was set, its second starts are not known yet
+            anchor_sec = sec;
+            anchor_us = now_us;
+        }
+        seen_sec = sec;
+    }
+    seen_us = now_us;
+    int64_t fraction = (int64_t)(now_us - anchor_us) - (sec - anchor_sec) * US_PER_SEC;
+    critical_section_exit(&epoch_lock);
+    // The RTC and the timer part by the drift until the next anchor
+    fraction = (fraction < 0) ? 0 : (fraction >= US_PER_SEC) ? US_PER_SEC - 1 : fraction;
+    return sec * US_PER_SEC + fraction;
+}
+
+void epoch_poll() {
+    epoch_now_us();
+}
@@ -0,0 +1,76 @@
+#ifndef _EPOCH_H_
+#define _EPOCH_H_
+
+#include "hardware/rtc.h"
+#include "calendar.h"
+
+// Time as a single 64-bit count of microseconds since 1970-01-01 00:00:00.
+// Comparisons and differences of times are plain integer operations, and
+// datetime_t is only needed at the edges: the RTC and the screen.
+
+typedef int64_t epoch_us_t;
+
+#define US_PER_SEC  1000000LL
+#define US_PER_MIN  (60 * US_PER_SEC)
+#define US_PER_HOUR (60 * US_PER_MIN)
+#define US_PER_DAY  (24 * US_PER_HOUR)
+
+constexpr int64_t datetime_to_epoch_sec(const datetime_t& t) {
+    return (int64_t)days_from_civil(t.year, t.month, t.day) * 86400 + t.hour * 3600 + t.min * 60 + t.sec;
+}
+
+constexpr epoch_us_t datetime_to_epoch_us(const datetime_t& t) {
+    return datetime_to_epoch_sec(t) * US_PER_SEC;
+}
+
+// Floors to the second, the weekday is filled in as well
+constexpr datetime_t epoch_us_to_datetime(epoch_us_t us) {
+    int64_t seconds = us / US_PER_SEC - (us % US_PER_SEC < 0);
+    int32_t days = (int32_t)(seconds / 86400 - (seconds % 86400 < 0));
+    int32_t second_of_day = (int32_t)(seconds - (int64_t)days * 86400);
+    const civil_date date = civil_from_days(days);
+    return datetime_t{
+        .year  = date.year,
+        .month = (int8_t)date.month,
+        .day   = (int8_t)date.day,
+        .dotw  = (int8_t)day_of_week(days),
+        .hour  = (int8_t)(second_of_day / 3600),
+        .min   = (int8_t)(second_of_day / 60 % 60),
+        .sec   = (int8_t)(second_of_day % 60),
+    };
+}
+
+// Whole units since the epoch, e.g. of US_PER_MIN, also before 1970
+constexpr int64_t epoch_floor(epoch_us_t us, int64_t unit) {
+    return us / unit - (us % unit < 0);
+}
+
+// The first time after now at second_of_day of a UTC day
+constexpr epoch_us_t epoch_next_at(epoch_us_t now, int32_t second_of_day) {
+    epoch_us_t at = epoch_floor(now, US_PER_DAY) * US_PER_DAY + second_of_day * US_PER_SEC;
+    return (at <= now) ? at + US_PER_DAY : at;
+}
+
+static_assert(datetime_to_epoch_sec(datetime_t{2022, 7, 1, 5, 12, 30, 15}) == 1656678615, "wrong epoch");
+static_assert(epoch_us_to_datetime(1656678615 * US_PER_SEC + 999999).sec == 15, "wrong rounding");
+static_assert(epoch_us_to_datetime(-1).year == 1969, "wrong rounding");
+static_assert(epoch_floor(-1, US_PER_MIN) == -1, "wrong rounding");
+static_assert(epoch_next_at(US_PER_DAY + 10 * US_PER_SEC, 10) == 2 * US_PER_DAY + 10 * US_PER_SEC, "wrong day");
+
+// Must be called once after rtc_init()
+void epoch_init();
+
+// Current UTC time. The RTC gives whole seconds and the microsecond timer
+// gives the fraction, counted from the start of an RTC second that was seen
+// within EPOCH_EDGE_US. The timer carries that start over the seconds in
+// between, however rarely the time is read, as both run from the crystal.
+// It goes backwards when the RTC is set, from SET CLOCK or the first host
+// sync, or stepped back by the drift compensation without divider trimming.
+// After the RTC is set, the fraction is 0 until the next start is seen.
+epoch_us_t epoch_now_us();
+
+// Reads the RTC so that the start of each second is seen, called often,
+// i.e. every loop of Core 1
+void epoch_poll();
+
+#endif
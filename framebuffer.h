@@ -0,0 +1,371 @@
+#ifndef _FRAMEBUFFER_H_
+#define _FRAMEBUFFER_H_
+
+#include <cstring>
+
+#include "pico/stdlib.h"
+
+struct GFXglyph {
+    uint16_t bitmapOffset;  ///< Pointer into GFXfont->bitmap
+    uint8_t width;          ///< Bitmap dimensions in pixels
+    uint8_t height;         ///< Bitmap dimensions in pixels
+    uint8_t xAdvance;       ///< Distance to advance cursor (x axis)
+    int8_t xOffset;         ///< X dist from cursor pos to UL corner
+    int8_t yOffset;         ///< Y dist from cursor pos to UL corner
+};
+
+struct GFXfont {
+    const uint8_t* bitmap;   ///< Glyph bitmaps, concatenated
+    const GFXglyph* glyph;   ///< Glyph array
+    uint8_t first;     ///< ASCII extents (first char)
+    uint8_t last;      ///< ASCII extents (last char)
+    uint8_t yAdvance;  ///< Newline distance (y axis)
+};
+
+// Where the font tables are kept. They are inline constexpr, so there is one
+// copy of each for all the files that include it, in flash and read through
+// the XIP cache. FONTS_IN_SRAM has them copied to SRAM at boot instead.
+#if FONTS_IN_SRAM
+#define FONT_DATA __not_in_flash("fonts")
+#else
+#define FONT_DATA
+#endif
+
+// Returns the width in pixels of a text printed on a single line
+constexpr uint16_t textWidth(const GFXfont& font, const char* text) {
+    uint16_t width = 0;
+    for (; *text; text++)
+        if (font.first <= (uint8_t)*text && (uint8_t)*text <= font.last)
+            width += font.glyph[(uint8_t)*text - font.first].xAdvance;
+    return width;
+}
+
+// Pixel formats. Each one provides the kernels that touch the pixel data,
+// so a Framebuffer of a format compiles to code for that layout only.
+// The kernels used by the display's SRAM functions are __force_inline, so
+// they are compiled into them and never left out of line in flash.
+// Levels are 0 (off) to MAX_LEVEL.
+
+// 1 bit per pixel, a byte is 8 rows of one column (SSD1306, SH1106)
+struct Mono1PageMajor {
+    static constexpr uint8_t MAX_LEVEL = 1;
+    static constexpr uint8_t BAND_HEIGHT = 8;  // Rows sent together, a page
+
+    static constexpr uint32_t bytes(uint16_t width, uint16_t height) {
+        return (uint32_t)width * height / 8;
+    }
+
+    // Pages of the image, which is turned to portrait by a quarter rotation
+    static constexpr uint16_t bands(uint16_t width, uint16_t height) {
+        return ((width > height) ? width : height) / BAND_HEIGHT;
+    }
+
+    static __force_inline void set(uint8_t* data, uint16_t width, uint16_t x, uint16_t y, uint8_t level) {
+        uint8_t* byte = data + x + width * (y / 8);
+        if (level)
+            *byte |= 0x01 << (y % 8);
+        else
+            *byte &= ~(0x01 << (y % 8));
+    }
+
+    // Bits of the rows y0 to y1 that are in the page
+    static __force_inline uint8_t pageMask(uint8_t page, uint16_t y0, uint16_t y1) {
+        uint8_t first = (y0 > page * 8) ? y0 - page * 8 : 0;
+        uint8_t last = (y1 < page * 8 + 7) ? y1 - page * 8 : 7;
+        return (0xFF << first) & (0xFF >> (7 - last));
+    }
+
+    // Sets the pixels of columns x0 to x1 and rows y0 to y1 to level
+    static __force_inline void fill(uint8_t* data, uint16_t width, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1,
+                            uint8_t level) {
+        for (uint8_t page = y0 / 8; page <= y1 / 8; page++) {
+            uint8_t mask = pageMask(page, y0, y1);
+            uint8_t* row = data + width * page;
+            for (uint16_t x = x0; x <= x1; x++)
+                row[x] = level ? row[x] | mask : row[x] & ~mask;
+        }
+    }
+
+    static __force_inline void invert(uint8_t* data, uint16_t width, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1) {
+        for (uint8_t page = y0 / 8; page <= y1 / 8; page++) {
+            uint8_t mask = pageMask(page, y0, y1);
+            uint8_t* row = data + width * page;
+            for (uint16_t x = x0; x <= x1; x++)
+                row[x] ^= mask;
+        }
+    }
+
+    // Sets the pixels of count columns of 8 rows from y0, a page, where
+    // the bits of the column bytes are set; they are bytes of this format
+    static __force_inline void columns(uint8_t* data, uint16_t width, uint16_t x0, uint16_t y0, uint16_t count,
+                                       const uint8_t* bytes, uint8_t level) {
+        (void)level;
+        uint8_t* row = data + width * (y0 / 8) + x0;
+        for (uint16_t i = 0; i < count; i++)
+            row[i] |= bytes[i];
+    }
+};
+
+// 4 bits per pixel, rows of bytes with the left pixel in the high nibble (SSD1322)
+struct Gray4RowMajor {
+    static constexpr uint8_t MAX_LEVEL = 15;
+    static constexpr uint8_t BAND_HEIGHT = 1;
+
+    static constexpr uint32_t bytes(uint16_t width, uint16_t height) {
+        return (uint32_t)width * height / 2;
+    }
+
+    // Rows; the image is never turned
+    static constexpr uint16_t bands(uint16_t width, uint16_t height) {
+        return height / BAND_HEIGHT;
+    }
+
+    static __force_inline void set(uint8_t* data, uint16_t width, uint16_t x, uint16_t y, uint8_t level) {
+        uint8_t* byte = data + (y * width + x) / 2;
+        if (x & 1)
+            *byte = (*byte & 0xF0) | level;
+        else
+            *byte = (*byte & 0x0F) | (level << 4);
+    }
+
+    // Whole bytes are written at once, only the odd pixels at the ends are nibbles
+    static __force_inline void fill(uint8_t* data, uint16_t width, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1,
+                            uint8_t level) {
+        for (uint16_t y = y0; y <= y1; y++) {
+            uint16_t x = x0, end = x1 + 1;
+            if (x & 1)
+                set(data, width, x++, y, level);
+            if ((end & 1) && end > x)
+                set(data, width, --end, y, level);
+            if (end > x)
+                memset(data + (y * width + x) / 2, level * 0x11, (end - x) / 2);
+        }
+    }
+
+    static __force_inline void invert(uint8_t* data, uint16_t width, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1) {
+        for (uint16_t y = y0; y <= y1; y++) {
+            uint8_t* row = data + y * width / 2;
+            for (uint16_t x = x0; x <= x1; x++)
+                row[x / 2] ^= (x & 1) ? 0x0F : 0xF0;
+        }
+    }
+
+    // Page columns, bit 0 the top row, are spread over the 8 rows
+    static __force_inline void columns(uint8_t* data, uint16_t width, uint16_t x0, uint16_t y0, uint16_t count,
+                                       const uint8_t* bytes, uint8_t level) {
+        for (uint16_t i = 0; i < count; i++)
+            for (uint8_t bit = 0; bit < 8; bit++)
+                if (bytes[i] & (1 << bit))
+                    set(data, width, x0 + i, y0 + bit, level);
+    }
+};
+
+// Pixels of a display in the given format, with the drawing kernels and
+// the columns changed in each band of rows since the last flush. The
+// driver owns the transfer; everything here is plain memory work.
+template <typename Format, uint16_t MAX_WIDTH, uint16_t MAX_HEIGHT>
+class Framebuffer {
+   public:
+    static constexpr uint16_t BANDS = Format::bands(MAX_WIDTH, MAX_HEIGHT);
+
+    uint8_t DATA[Format::bytes(MAX_WIDTH, MAX_HEIGHT)];
+    uint16_t WIDTH;
+    uint16_t HEIGHT;
+    uint8_t LEVEL;  // Level of the pixels drawn
+    const GFXfont* FONT;
+
+    // Changed columns of each band, none when DIRTY_X0 > DIRTY_X1
+    uint16_t DIRTY_X0[BANDS], DIRTY_X1[BANDS];
+
+    void init(uint16_t width, uint16_t height, const GFXfont* font) {
+        WIDTH = width, HEIGHT = height;
+        LEVEL = Format::MAX_LEVEL;
+        FONT = font;
+        for (uint16_t band = 0; band < BANDS; band++)
+            markClean(band);
+        clear();
+    }
+
+    __force_inline bool isDirty(uint16_t band) const {
+        return DIRTY_X0[band] <= DIRTY_X1[band];
+    }
+
+    __force_inline void markClean(uint16_t band) {
+        DIRTY_X0[band] = 0xFFFF, DIRTY_X1[band] = 0;
+    }
+
+    __force_inline void markDirty(int16_t x, int16_t y, int16_t width, int16_t height) {
+        if (width <= 0 || height <= 0 || x >= WIDTH || y >= HEIGHT)
+            return;
+        int16_t x2 = x + width - 1, y2 = y + height - 1;
+        if (x2 < 0 || y2 < 0)
+            return;
+        x = (x < 0) ? 0 : x, y = (y < 0) ? 0 : y;
+        x2 = (x2 >= WIDTH) ? WIDTH - 1 : x2, y2 = (y2 >= HEIGHT) ? HEIGHT - 1 : y2;
+        for (uint16_t band = y / Format::BAND_HEIGHT; band <= y2 / Format::BAND_HEIGHT; band++) {
+            if (x < DIRTY_X0[band])
+                DIRTY_X0[band] = x;
+            if (x2 > DIRTY_X1[band])
+                DIRTY_X1[band] = x2;
+        }
+    }
+
+    void clear() {
+        memset(DATA, 0, Format::bytes(WIDTH, HEIGHT));
+        markDirty(0, 0, WIDTH, HEIGHT);
+    }
+
+    // Callers mark the area they draw in as dirty
+    __force_inline void setPixel(int16_t x, int16_t y) {
+        if (0 <= x && x < WIDTH && 0 <= y && y < HEIGHT)
+            Format::set(DATA, WIDTH, x, y, LEVEL);
+    }
+
+    __force_inline void fillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint8_t level) {
+        int16_t x2 = x + width - 1, y2 = y + height - 1;
+        x = (x < 0) ? 0 : x, y = (y < 0) ? 0 : y;
+        x2 = (x2 >= WIDTH) ? WIDTH - 1 : x2, y2 = (y2 >= HEIGHT) ? HEIGHT - 1 : y2;
+        if (x > x2 || y > y2)
+            return;
+        Format::fill(DATA, WIDTH, x, x2, y, y2, level);
+        markDirty(x, y, x2 - x + 1, y2 - y + 1);
+    }
+
+    void invertRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+        int16_t x2 = x + width - 1, y2 = y + height - 1;
+        x = (x < 0) ? 0 : x, y = (y < 0) ? 0 : y;
+        x2 = (x2 >= WIDTH) ? WIDTH - 1 : x2, y2 = (y2 >= HEIGHT) ? HEIGHT - 1 : y2;
+        if (x > x2 || y > y2)
+            return;
+        Format::invert(DATA, WIDTH, x, x2, y, y2);
+        markDirty(x, y, x2 - x + 1, y2 - y + 1);
+    }
+
+    // Bresenham, integer steps only
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+        int16_t dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+        int16_t dy = (y1 > y0) ? y0 - y1 : y1 - y0;  // Negative
+        int8_t sx = (x0 < x1) ? 1 : -1, sy = (y0 < y1) ? 1 : -1;
+        markDirty((x0 < x1) ? x0 : x1, (y0 < y1) ? y0 : y1, dx + 1, 1 - dy);
+        int16_t error = dx + dy;
+        while (true) {
+            setPixel(x0, y0);
+            if (x0 == x1 && y0 == y1)
+                break;
+            int16_t e2 = 2 * error;
+            if (e2 >= dy)
+                error += dy, x0 += sx;
+            if (e2 <= dx)
+                error += dx, y0 += sy;
+        }
+    }
+
+    void drawCircle(int16_t xc, int16_t yc, uint16_t r) {
+        markDirty(xc - r, yc - r, 2 * r + 1, 2 * r + 1);
+        int16_t x = -r;
+        int16_t y = 0;
+        int16_t e = 2 - (2 * r);
+        do {
+            setPixel(xc + x, yc - y);
+            setPixel(xc - x, yc + y);
+            setPixel(xc + y, yc + x);
+            setPixel(xc - y, yc - x);
+            int16_t _e = e;
+            if (_e <= y)
+                e += (++y * 2) + 1;
+            if ((_e > x) || (e > y))
+                e += (++x * 2) + 1;
+        } while (x < 0);
+    }
+
+    void drawFilledCircle(int16_t xc, int16_t yc, uint16_t r) {
+        int16_t x = r;
+        int16_t y = 0;
+        int16_t e = 1 - x;
+        while (x >= y) {
+            fillRect(xc - x, yc + y, 2 * x + 1, 1, LEVEL);
+            fillRect(xc - y, yc + x, 2 * y + 1, 1, LEVEL);
+            fillRect(xc - x, yc - y, 2 * x + 1, 1, LEVEL);
+            fillRect(xc - y, yc - x, 2 * y + 1, 1, LEVEL);
+            ++y;
+            if (e >= 0) {
+                x--;
+                e += 2 * ((y - x) + 1);
+            }
+            else
+                e += (2 * y) + 1;
+        }
+    }
+
+    void drawRectangle(int16_t x, int16_t y, int16_t width, int16_t height) {
+        fillRect(x, y, width, 1, LEVEL);
+        fillRect(x, y + height - 1, width, 1, LEVEL);
+        fillRect(x, y, 1, height, LEVEL);
+        fillRect(x + width - 1, y, 1, height, LEVEL);
+    }
+
+    // Columns of one page, 8 rows from 8 * page, bit 0 being the top row.
+    // The rows are pixels of the buffer's own format, so a mono buffer copies
+    // them without any per-pixel work.
+    __force_inline void drawColumns(int16_t x, uint8_t page, uint16_t width, const uint8_t* columns) {
+        if (page >= HEIGHT / 8 || x >= WIDTH)
+            return;
+        if (x < 0) {
+            columns -= x, width = (width > -x) ? width + x : 0;
+            x = 0;
+        }
+        width = (x + width > WIDTH) ? WIDTH - x : width;
+        Format::columns(DATA, WIDTH, x, page * 8, width, columns, LEVEL);
+        markDirty(x, page * 8, width, 8);
+    }
+
+    // 1 bit per pixel, rows of bytes with the left pixel in the high bit
+    void drawBitmap(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t* image) {
+        markDirty(x, y, width, height);
+        uint16_t row_bytes = (width + 7) / 8;
+        for (uint16_t i = 0; i < height; i++)
+            for (uint16_t j = 0; j < width; j++)
+                if (image[i * row_bytes + j / 8] & (0x80 >> (j % 8)))
+                    setPixel(x + j, y + i);
+    }
+
+    __force_inline void drawChar(int16_t x, int16_t y, uint8_t character) {
+        if (character < FONT->first || character > FONT->last)
+            return;
+        const GFXglyph* glyph = FONT->glyph + character - FONT->first;
+        const uint8_t* bitmap = FONT->bitmap + glyph->bitmapOffset;
+        uint8_t width = glyph->width, height = glyph->height;
+        x += glyph->xOffset;
+        y += FONT->yAdvance + glyph->yOffset;
+        uint8_t bits = 0, abit = 0;
+        markDirty(x, y, width, height);
+
+        for (uint8_t i = 0; i < height; i++) {
+            for (uint8_t j = 0; j < width; j++) {
+                if (!(abit++ & 7)) {
+                    bits = *bitmap++;
+                }
+                if (bits & 0x80) {
+                    setPixel(x + j, y + i);
+                }
+                bits <<= 1;
+            }
+        }
+    }
+
+    // Wraps to the next line at the right edge
+    __force_inline void print(int16_t x, int16_t y, const char* string) {
+        for (; *string; string++) {
+            uint8_t character = *string;
+            const GFXglyph* glyph = FONT->glyph + character - FONT->first;
+            if (x + glyph->width + glyph->xOffset > WIDTH) {
+                x = 0;
+                y += FONT->yAdvance;
+            }
+            drawChar(x, y, character);
+            x += glyph->xAdvance;
+        }
+    }
+};
+
+#endif
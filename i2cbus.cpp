@@ -0,0 +1,166 @@
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "i2cbus.h"
+
+static I2CBus bus0(i2c0), bus1(i2c1);
+
+static void __not_in_flash("i2cbus") i2c0_irq() {
+    bus0.handleIrq();
+}
+
+static void __not_in_flash("i2cbus") i2c1_irq() {
+    bus1.handleIrq();
+}
+
+I2CBus& i2c_bus(i2c_inst_t* i2c) {
+    return (i2c == i2c0) ? bus0 : bus1;
+}
+
+I2CBus::I2CBus(i2c_inst_t* i2c) {
+    I2C_PORT = i2c;
+    READY = false;
+    QUEUED = 0;
+    ACTIVE = nullptr;
+}
+
+void I2CBus::init(uint8_t scl, uint8_t sda, uint32_t freq) {
+    if (READY)
+        return;
+    READY = true;
+    ADDRESS = 0xFF;
+    critical_section_init(&LOCK);
+
+    i2c_init(I2C_PORT, freq);
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+
+    DMA_CHANNEL = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(DMA_CHANNEL);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(I2C_PORT, true));
+    dma_channel_configure(DMA_CHANNEL, &config, &i2c_get_hw(I2C_PORT)->data_cmd, nullptr, 0, false);
+
+    // A transaction ends with its STOP, also after an abort
+    i2c_hw_t* hw = i2c_get_hw(I2C_PORT);
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    uint irq = (I2C_PORT == i2c0) ? I2C0_IRQ : I2C1_IRQ;
+    irq_set_exclusive_handler(irq, (I2C_PORT == i2c0) ? i2c0_irq : i2c1_irq);
+    irq_set_enabled(irq, true);
+}
+
+// Called with the lock held
+void __not_in_flash("i2cbus") I2CBus::startNext() {
+    if (ACTIVE || QUEUED == 0)
+        return;
+    ACTIVE = QUEUE[0];
+    QUEUED--;
+    for (uint8_t i = 0; i < QUEUED; i++)
+        QUEUE[i] = QUEUE[i + 1];
+    // The target can only be changed once the controller reads as disabled;
+    // the bus is idle after a STOP, so that takes a few clocks
+    if (ACTIVE->address != ADDRESS) {
+        i2c_hw_t* hw = i2c_get_hw(I2C_PORT);
+        hw->enable = 0;
+        while (hw->enable_status & I2C_IC_ENABLE_STATUS_IC_EN_BITS)
+            tight_loop_contents();
+        hw->tar = ACTIVE->address;
+        hw->enable = 1;
+        ADDRESS = ACTIVE->address;
+    }
+    dma_channel_transfer_from_buffer_now(DMA_CHANNEL, ACTIVE->words, ACTIVE->count);
+}
+
+void __not_in_flash("i2cbus") I2CBus::submit(I2CTransaction* t) {
+    t->done = false, t->failed = false;
+    critical_section_enter_blocking(&LOCK);
+    while (QUEUED == I2C_BUS_QUEUE) {
+        critical_section_exit(&LOCK);
+        tight_loop_contents();
+        critical_section_enter_blocking(&LOCK);
+    }
+    // After the ones with the same or a higher priority
+    uint8_t i = QUEUED++;
+    for (; i > 0 && QUEUE[i - 1]->priority < t->priority; i--)
+        QUEUE[i] = QUEUE[i - 1];
+    QUEUE[i] = t;
+    startNext();
+    critical_section_exit(&LOCK);
+}
+
+bool I2CBus::wait(I2CTransaction* t) {
+    while (!t->done)
+        tight_loop_contents();
+    return !t->failed;
+}
+
+bool I2CBus::transfer(uint8_t address, const uint8_t* tx, uint16_t tx_count, uint8_t* rx, uint8_t rx_count,
+                      uint8_t priority) {
+    if (tx_count + rx_count == 0 || tx_count > I2C_BUS_MAX_WRITE || rx_count > I2C_BUS_MAX_READ)
+        return false;
+    uint16_t words[I2C_BUS_MAX_WRITE + I2C_BUS_MAX_READ];
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < tx_count; i++)
+        words[count++] = tx[i];
+    for (uint8_t i = 0; i < rx_count; i++)
+        words[count++] = I2C_IC_DATA_CMD_CMD_BITS;  // Read a byte
+    words[count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    I2CTransaction t = {words, count, address, priority, rx, rx_count, false, false};
+    submit(&t);
+    return wait(&t);
+}
+
+bool I2CBus::write(uint8_t address, const uint8_t* bytes, uint16_t count, uint8_t priority) {
+    return transfer(address, bytes, count, nullptr, 0, priority);
+}
+
+bool I2CBus::read(uint8_t address, uint8_t* bytes, uint8_t count, uint8_t priority) {
+    return transfer(address, nullptr, 0, bytes, count, priority);
+}
+
+uint32_t I2CBus::setFrequency(uint32_t freq) {
+    critical_section_enter_blocking(&LOCK);
+    while (ACTIVE || QUEUED) {
+        critical_section_exit(&LOCK);
+        tight_loop_contents();
+        critical_section_enter_blocking(&LOCK);
+    }
+    freq = i2c_set_baudrate(I2C_PORT, freq);
+    critical_section_exit(&LOCK);
+    return freq;
+}
+
+void __not_in_flash("i2cbus") I2CBus::handleIrq() {
+    i2c_hw_t* hw = i2c_get_hw(I2C_PORT);
+    uint32_t status = hw->intr_stat;
+    if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // Not acknowledged: the controller drops the FIFO and sends a STOP,
+        // the rest of the transaction is dropped too
+        dma_channel_abort(DMA_CHANNEL);
+        (void)hw->clr_tx_abrt;
+        if (ACTIVE)
+            ACTIVE->failed = true;
+    }
+    if (!(status & I2C_IC_INTR_STAT_R_STOP_DET_BITS))
+        return;
+    (void)hw->clr_stop_det;
+
+    critical_section_enter_blocking(&LOCK);
+    I2CTransaction* t = ACTIVE;
+    if (t) {
+        uint8_t i = 0;
+        for (; i < t->rx_count && hw->rxflr; i++)
+            t->rx[i] = hw->data_cmd;
+        if (i < t->rx_count)
+            t->failed = true;
+        while (hw->rxflr)
+            (void)hw->data_cmd;
+        t->done = true;
+        ACTIVE = nullptr;
+    }
+    startNext();
+    critical_section_exit(&LOCK);
+}
@@ -0,0 +1,71 @@
+#ifndef _I2CBUS_H_
+#define _I2CBUS_H_
+
+#include "hardware/i2c.h"
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+
+// Shared I2C bus. Every device driver on a bus queues its transactions
+// here instead of owning the controller. One transaction at a time is sent
+// by DMA into the data register; the STOP interrupt ends it and starts the
+// next one with the highest priority, so a sensor read waits for one page
+// of a display flush at most, not for the whole frame.
+
+#define I2C_BUS_QUEUE     16   // Transactions waiting, per bus
+#define I2C_BUS_MAX_WRITE 136  // Bytes of a blocking transfer, a display page and its window
+#define I2C_BUS_MAX_READ  16   // Bytes of one read, the depth of the receive FIFO
+
+// Priorities, higher ones are sent first and equal ones in order
+#define I2C_PRIORITY_DISPLAY 0  // Flushes, one transaction per page
+#define I2C_PRIORITY_DEVICE  1  // Sensors, EEPROMs
+#define I2C_PRIORITY_CONTROL 2  // Blocking transfers, e.g. display commands
+
+struct I2CTransaction {
+    const uint16_t* words;  // For the data register, with the STOP bit on the last one only
+    uint16_t count;
+    uint8_t address;
+    uint8_t priority;
+    uint8_t* rx;       // Bytes of the read commands among the words
+    uint8_t rx_count;
+    volatile bool done;
+    volatile bool failed;  // Not acknowledged, or fewer bytes read
+};
+
+class I2CBus {
+   private:
+    i2c_inst_t* I2C_PORT;
+    bool READY;
+    uint8_t DMA_CHANNEL;
+    uint8_t ADDRESS;  // Target the controller is set to
+    critical_section_t LOCK;
+    I2CTransaction* QUEUE[I2C_BUS_QUEUE];  // By priority
+    uint8_t QUEUED;
+    I2CTransaction* ACTIVE;
+
+    void startNext();
+
+   public:
+    I2CBus(i2c_inst_t* i2c);
+    // Only the first call sets the pins and the rate, later drivers share them.
+    // The bus interrupt runs on the calling core.
+    void init(uint8_t scl, uint8_t sda, uint32_t freq);
+    // Queues t, which must stay untouched until it is done. Waits for a free
+    // slot when the queue is full; not to be called from an interrupt.
+    void submit(I2CTransaction* t);
+    // Returns false if t failed
+    bool wait(I2CTransaction* t);
+    // Writes tx and then reads rx_count bytes after a repeated start, either
+    // may be empty, and waits for the end. Returns false if not acknowledged.
+    bool transfer(uint8_t address, const uint8_t* tx, uint16_t tx_count, uint8_t* rx, uint8_t rx_count,
+                  uint8_t priority = I2C_PRIORITY_CONTROL);
+    bool write(uint8_t address, const uint8_t* bytes, uint16_t count, uint8_t priority = I2C_PRIORITY_CONTROL);
+    bool read(uint8_t address, uint8_t* bytes, uint8_t count, uint8_t priority = I2C_PRIORITY_CONTROL);
+    // Waits until the bus is idle; returns the rate that is actually set
+    uint32_t setFrequency(uint32_t freq);
+    void handleIrq();
+};
+
+// The bus of an I2C controller
+I2CBus& i2c_bus(i2c_inst_t* i2c);
+
+#endif
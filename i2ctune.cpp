@@ -0,0 +1,49 @@
+#include "i2ctune.h"
+#include "serialout.h"
+
+// The last result, for the report; tuned_freq is 0 before the first tuning
+static uint32_t tuned_freq = 0;
+static uint32_t passed_freq = 0;  // 0 when the stored rate was verified
+
+static bool stable(OLED& oled, uint32_t freq) {
+    oled.setFrequency(freq);
+    for (uint8_t i = 0; i < I2C_TUNE_CHECKS; i++)
+        if (!oled.verifyBus())
+            return false;
+    return true;
+}
+
+uint32_t i2c_tune(OLED& oled, uint32_t base, uint32_t stored) {
+    if (stored >= base && stored <= I2C_TUNE_MAX_FREQ && stable(oled, stored)) {
+        tuned_freq = stored, passed_freq = 0;
+        return stored;
+    }
+    uint32_t fastest = base;
+    for (uint32_t freq = base + I2C_TUNE_STEP; freq <= I2C_TUNE_MAX_FREQ; freq += I2C_TUNE_STEP) {
+        if (!stable(oled, freq))
+            break;
+        fastest = freq;
+    }
+    uint32_t freq = (fastest > base) ? fastest - I2C_TUNE_STEP : base;
+    oled.setFrequency(freq);
+    // A failed step may have cut a command off
+    oled.reset();
+    tuned_freq = freq, passed_freq = fastest;
+    return freq;
+}
+
+void i2c_tune_report() {
+    if (tuned_freq == 0)
+        return;
+    if (passed_freq == 0) {
+        serial_print("i2c ");
+        serial_print_number(tuned_freq);
+        serial_print(" Hz\n");
+        return;
+    }
+    serial_print("i2c tuned to ");
+    serial_print_number(tuned_freq);
+    serial_print(" Hz, ");
+    serial_print_number(passed_freq);
+    serial_print(" Hz passed\n");
+}
@@ -0,0 +1,25 @@
+#ifndef _I2CTUNE_H_
+#define _I2CTUNE_H_
+
+#include "OLED.h"
+
+// I2C clock tuning for the display.
+//
+// Many SSD1306 modules run well above 400 kHz with short wiring. The clock
+// is stepped up from the base rate and every step has to pass
+// OLED::verifyBus() I2C_TUNE_CHECKS times in a row. The fastest step that
+// passes is not used; the one below it is, as a safety margin. The result
+// is stored in the settings and only verified at the next start.
+
+#define I2C_TUNE_MAX_FREQ 1000000 // Fast-mode Plus
+#define I2C_TUNE_STEP     100000
+#define I2C_TUNE_CHECKS   4
+
+// Returns the rate the display is left at; stored is the last result, 0 if none
+uint32_t i2c_tune(OLED& oled, uint32_t base, uint32_t stored);
+
+// Prints the result over USB; the tuning runs before the host can have the
+// port open, so it is printed once the host connects
+void i2c_tune_report();
+
+#endif
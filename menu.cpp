@@ -0,0 +1,63 @@
+#include "menu.h"
+
+static constexpr MenuLabel marker("-");
+
+void menu_open(MenuState* state, const Menu* top) {
+    state->path[0] = top;
+    state->index[0] = 0;
+    state->depth = 0;
+}
+
+void menu_previous(MenuState* state) {
+    uint8_t count = state->path[state->depth]->count;
+    uint8_t& index = state->index[state->depth];
+    index = (index == 0) ? count - 1 : index - 1;
+}
+
+void menu_next(MenuState* state) {
+    uint8_t count = state->path[state->depth]->count;
+    uint8_t& index = state->index[state->depth];
+    index = (index == count - 1) ? 0 : index + 1;
+}
+
+void menu_select(MenuState* state) {
+    const MenuItem& item = state->path[state->depth]->items[state->index[state->depth]];
+    if (item.submenu && state->depth + 1 < MENU_DEPTH) {
+        // Set up before the depth changes, Core 0 may be drawing
+        state->path[state->depth + 1] = item.submenu;
+        state->index[state->depth + 1] = 0;
+        state->depth++;
+    }
+    else if (item.action) {
+        menu_open(state, state->path[0]);
+        item.action();
+    }
+}
+
+bool menu_back(MenuState* state) {
+    if (state->depth == 0)
+        return false;
+    state->depth--;
+    return true;
+}
+
+static void draw_label(Display& oled, uint8_t x, uint8_t row, const MenuLabel& label) {
+    for (uint8_t page = 0; page < MENU_ROW_HEIGHT / 8; page++)
+        oled.drawColumns(x, row * (MENU_ROW_HEIGHT / 8) + page, label.width, label.columns[page]);
+}
+
+void draw_menu(Display& oled, const MenuState* state) {
+    const Menu* menu = state->path[state->depth];
+    uint8_t index = state->index[state->depth];
+    if (index >= menu->count)  // Core 1 changed the menu meanwhile
+        index = 0;
+    // Scroll so that the selected item is on the screen
+    uint8_t rows = oled.getHeight() / MENU_ROW_HEIGHT;
+    uint8_t first = (index < rows) ? 0 : index - rows + 1;
+    for (uint8_t row = 0; row < rows && first + row < menu->count; row++) {
+        const MenuItem& item = menu->items[first + row];
+        bool alternate = item.alternate && item.alternate();
+        draw_label(oled, MENU_INDENT, row, alternate ? *item.alternate_label : *item.label);
+    }
+    draw_label(oled, 0, index - first, marker);
+}
@@ -0,0 +1,79 @@
+#ifndef _MENU_H_
+#define _MENU_H_
+
+#include "display.h"
+#include "Dialog_bold_16.h"
+
+// Menus are trees of items made at compile time. Each item has its label
+// drawn in the default font when the firmware is compiled, as page columns
+// that are copied into the buffer as they are, and either opens a submenu
+// or runs an action. Core 1 moves through the menus with the buttons and
+// Core 0 draws them; when there are more items than rows, the rows scroll
+// with the selected one.
+
+#define MENU_ROW_HEIGHT 16       // Two pages
+#define MENU_LABEL_WIDTH 120     // Right of the marker
+#define MENU_LABEL_BASELINE 14   // Row of the baseline in a label
+#define MENU_INDENT 8            // Labels are after the marker
+#define MENU_DEPTH 4
+
+struct MenuLabel {
+    uint8_t width;
+    uint8_t columns[MENU_ROW_HEIGHT / 8][MENU_LABEL_WIDTH];  // Bit 0 is the top row of the page
+
+    // A text that does not fit does not compile
+    constexpr MenuLabel(const char* text) : width(0), columns{} {
+        const GFXfont& font = Dialog_bold_16;
+        int16_t x = 0;
+        for (; *text; text++) {
+            const GFXglyph& glyph = font.glyph[(uint8_t)*text - font.first];
+            const uint8_t* bitmap = font.bitmap + glyph.bitmapOffset;
+            uint16_t bit = 0;
+            for (uint8_t i = 0; i < glyph.height; i++)
+                for (uint8_t j = 0; j < glyph.width; j++, bit++) {
+                    if (!(bitmap[bit / 8] & (0x80 >> (bit % 8))))
+                        continue;
+                    int16_t px = x + glyph.xOffset + j, py = MENU_LABEL_BASELINE + glyph.yOffset + i;
+                    columns[py / 8][px] |= 1 << (py % 8);
+                    if (px >= width)
+                        width = px + 1;
+                }
+            x += glyph.xAdvance;
+        }
+    }
+};
+
+struct Menu;
+
+struct MenuItem {
+    const MenuLabel* label;
+    const MenuLabel* alternate_label;  // Shown instead while alternate() is true
+    bool (*alternate)();
+    const Menu* submenu;  // Opened by select, or else
+    void (*action)();     // run by select, after going back to the top menu
+};
+
+struct Menu {
+    const MenuItem* items;
+    uint8_t count;
+};
+
+// The open menus, from the top one, and the item selected in each
+struct MenuState {
+    const Menu* path[MENU_DEPTH];
+    uint8_t index[MENU_DEPTH];
+    uint8_t depth;
+};
+
+// Opens the top menu at its first item
+void menu_open(MenuState* state, const Menu* top);
+// Move the selection, wrapping around
+void menu_previous(MenuState* state);
+void menu_next(MenuState* state);
+void menu_select(MenuState* state);
+// Goes back to the item the open menu was opened from; false in the top menu
+bool menu_back(MenuState* state);
+// Draws the rows that fit on the screen and the marker of the selected item
+void draw_menu(Display& oled, const MenuState* state);
+
+#endif
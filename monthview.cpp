@@ -0,0 +1,88 @@
+#include "monthview.h"
+#include "Compact_5x7.h"
+#include "calendar.h"
+
+#define CELL_WIDTH 18
+#define GRID_X 1        // (128 - 7 * CELL_WIDTH) / 2
+#define GRID_PAGE 2     // Each row of the grid is one page
+#define DIGIT_WIDTH 3
+#define DIGIT_TOP 2     // Row of the digits inside the page
+
+static constexpr char digit_rows[10][5][4] = {
+    {"###", "#.#", "#.#", "#.#", "###"}, {".#.", "##.", ".#.", ".#.", "###"},
+    {"###", "..#", "###", "#..", "###"}, {"###", "..#", "###", "..#", "###"},
+    {"#.#", "#.#", "###", "..#", "..#"}, {"###", "#..", "###", "..#", "###"},
+    {"###", "#..", "###", "#.#", "###"}, {"###", "..#", "..#", "..#", "..#"},
+    {"###", "#.#", "###", "#.#", "###"}, {"###", "#.#", "###", "..#", "###"},
+};
+
+// Digits as page columns, ready to be copied into the buffer
+struct DigitAtlas {
+    uint8_t columns[10][DIGIT_WIDTH];
+
+    constexpr DigitAtlas() : columns{} {
+        for (uint8_t digit = 0; digit < 10; digit++)
+            for (uint8_t column = 0; column < DIGIT_WIDTH; column++)
+                for (uint8_t row = 0; row < 5; row++)
+                    if (digit_rows[digit][row][column] == '#')
+                        columns[digit][column] |= 1 << (row + DIGIT_TOP);
+    }
+};
+
+static constexpr DigitAtlas atlas;
+
+// Left edges of the cells and of the digits inside them
+struct CellGeometry {
+    uint8_t cell_x[7];
+    uint8_t one_digit_x[7];
+    uint8_t two_digits_x[7];
+
+    constexpr CellGeometry() : cell_x{}, one_digit_x{}, two_digits_x{} {
+        for (uint8_t column = 0; column < 7; column++) {
+            cell_x[column] = GRID_X + column * CELL_WIDTH;
+            one_digit_x[column] = cell_x[column] + (CELL_WIDTH - DIGIT_WIDTH) / 2;
+            two_digits_x[column] = cell_x[column] + (CELL_WIDTH - 2 * DIGIT_WIDTH - 1) / 2;
+        }
+    }
+};
+
+static constexpr CellGeometry geometry;
+
+static const char month_titles[12][4] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                                         "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+static const char weekday_initials[] = "MTWTFSS";
+
+void draw_month_view(Display& oled, int16_t year, uint8_t month, uint8_t today) {
+    const GFXfont* font = oled.getFont();
+    oled.clear();
+    oled.setFont(&Compact_5x7);
+
+    // Title, e.g. "JUL 2022"
+    char title[9] = {month_titles[month-1][0], month_titles[month-1][1], month_titles[month-1][2], ' ',
+                     (char)('0' + year / 1000), (char)('0' + year / 100 % 10), (char)('0' + year / 10 % 10),
+                     (char)('0' + year % 10), '\0'};
+    oled.print((128 - 8 * 6) / 2, 0, (uint8_t *)title);
+    for (uint8_t column = 0; column < 7; column++)
+        oled.printChar(geometry.cell_x[column] + (CELL_WIDTH - 5) / 2, 8, weekday_initials[column]);
+    oled.setFont(font);
+
+    // Monday is the first column
+    uint8_t column = (day_of_week(year, month, 1) + 6) % 7;
+    uint8_t page = GRID_PAGE;
+    const uint8_t count = days_in_month(year, month);
+    for (uint8_t day = 1; day <= count; day++) {
+        if (day < 10) {
+            oled.drawColumns(geometry.one_digit_x[column], page, DIGIT_WIDTH, atlas.columns[day]);
+        }
+        else {
+            oled.drawColumns(geometry.two_digits_x[column], page, DIGIT_WIDTH, atlas.columns[day / 10]);
+            oled.drawColumns(geometry.two_digits_x[column] + DIGIT_WIDTH + 1, page, DIGIT_WIDTH, atlas.columns[day % 10]);
+        }
+        if (day == today)
+            oled.invertRegion(geometry.cell_x[column], page * 8, CELL_WIDTH, 8);
+        if (++column == 7) {
+            column = 0;
+            page++;
+        }
+    }
+}
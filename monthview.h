@@ -0,0 +1,12 @@
+#ifndef _MONTHVIEW_H_
+#define _MONTHVIEW_H_
+
+#include "display.h"
+
+// Draws the month as a grid of 7 columns, Monday first, and up to 6 rows.
+// The title and the weekday initials use the compact font, the days are
+// blitted from a pre-rendered 3x5 digit atlas into page-aligned cells.
+// today is the day of the month to highlight, 0 for none.
+void draw_month_view(Display& oled, int16_t year, uint8_t month, uint8_t today);
+
+#endif
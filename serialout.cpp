@@ -0,0 +1,31 @@
+#include "pico/stdio.h"
+#include "pico/stdio_usb.h"
+#include "serialout.h"
+
+void serial_print(const char* text) {
+    while (*text)
+        putchar_raw(*text++);
+}
+
+void serial_print_number(int64_t value, uint8_t digits, bool sign) {
+    char text[21];  // 19 digits of an int64_t and the sign
+    uint64_t magnitude = (value < 0) ? -(uint64_t)value : (uint64_t)value;
+    char* out = text + sizeof(text) - 1;
+    *out = '\0';
+    do {
+        *--out = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude || text + sizeof(text) - 1 - out < digits);
+    if (value < 0)
+        *--out = '-';
+    else if (sign)
+        *--out = '+';
+    serial_print(out);
+}
+
+bool serial_host_connected() {
+    static bool connected = false;
+    bool was = connected;
+    connected = stdio_usb_connected();
+    return connected && !was;
+}
@@ -0,0 +1,18 @@
+#ifndef _SERIALOUT_H_
+#define _SERIALOUT_H_
+
+#include "pico/stdlib.h"
+
+// Text output over the USB serial port without printf. Only strings and
+// decimal numbers are written, so no formatting code is linked in.
+
+void serial_print(const char* text);
+
+// Writes value in decimal with at least digits digits, with leading zeros.
+// sign also writes '+' before values that are not negative.
+void serial_print_number(int64_t value, uint8_t digits = 1, bool sign = false);
+
+// True once each time the host opens the port, for the reports made before
+bool serial_host_connected();
+
+#endif
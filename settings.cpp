@@ -0,0 +1,64 @@
+#include <cstddef>
+#include <cstring>
+
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "settings.h"
+
+#define SETTINGS_MAGIC  0x53434C41 // "ALCS"
+#define SETTINGS_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+static_assert(sizeof(Settings) <= FLASH_PAGE_SIZE, "settings must fit in a flash page");
+
+Settings settings;
+
+#define SETTINGS_HEADER_SIZE offsetof(Settings, drift_ppb)
+
+static const Settings default_settings = {
+    .magic = SETTINGS_MAGIC,
+    .size = sizeof(Settings),
+    .checksum = 0,
+    .drift_ppb = 0,
+    .drift_correction = 0,
+    .clock_layout = 0,
+    .i2c_freq = 0,
+};
+
+static uint32_t checksum(const Settings* s, uint32_t size) {
+    // FNV-1a over everything after the header
+    const uint8_t* bytes = (const uint8_t*)s;
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = SETTINGS_HEADER_SIZE; i < size; i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+void settings_load() {
+    const Settings* stored = (const Settings*)(XIP_BASE + SETTINGS_OFFSET);
+    settings = default_settings;
+    if (stored->magic == SETTINGS_MAGIC && SETTINGS_HEADER_SIZE <= stored->size &&
+        stored->size <= FLASH_PAGE_SIZE && stored->checksum == checksum(stored, stored->size)) {
+        uint32_t size = (stored->size < sizeof(Settings)) ? stored->size : sizeof(Settings);
+        memcpy((uint8_t*)&settings + SETTINGS_HEADER_SIZE, (const uint8_t*)stored + SETTINGS_HEADER_SIZE,
+               size - SETTINGS_HEADER_SIZE);
+        settings.size = sizeof(Settings);
+    }
+}
+
+void settings_save() {
+    static uint8_t page[FLASH_PAGE_SIZE];
+    settings.magic = SETTINGS_MAGIC;
+    settings.size = sizeof(Settings);
+    settings.checksum = checksum(&settings, sizeof(Settings));
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, &settings, sizeof(settings));
+
+    // Nothing may run from the flash while it is written
+    multicore_lockout_start_blocking();
+    uint32_t interrupts = save_and_disable_interrupts();
+    flash_range_erase(SETTINGS_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(SETTINGS_OFFSET, page, FLASH_PAGE_SIZE);
+    restore_interrupts(interrupts);
+    multicore_lockout_end_blocking();
+}
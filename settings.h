@@ -0,0 +1,29 @@
+#ifndef _SETTINGS_H_
+#define _SETTINGS_H_
+
+#include "pico/stdlib.h"
+
+// Values kept across power cycles in the last sector of the flash
+
+// New members are added to the end, so older saved settings still load
+// and the new members keep their defaults
+struct Settings {
+    uint32_t magic;
+    uint32_t size;              // sizeof(Settings) when it was saved
+    uint32_t checksum;          // Over the bytes after the header
+    int32_t drift_ppb;          // Measured RTC drift, positive when the RTC runs fast
+    int32_t drift_correction;   // Seconds the RTC has been corrected by in total
+    uint8_t clock_layout;       // Index into clock_layouts, or an analog face
+    uint32_t i2c_freq;          // Tuned display I2C clock, 0 before the first tuning
+};
+
+extern Settings settings;
+
+// Loads the settings from the flash, or the defaults if there are none
+void settings_load();
+
+// Writes the settings to the flash
+// Must be called from Core 1; Core 0 is paused while the flash is written
+void settings_save();
+
+#endif
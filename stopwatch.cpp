@@ -0,0 +1,178 @@
+#include <cstring>
+
+#include "pico/sync.h"
+#include "stopwatch.h"
+#include "Compact_5x7.h"
+
+#define TIME_CELLS 8        // MM:SS.hh
+#define TIME_DIGIT_TOP 11   // Top row of the digits printed at y = 4
+#define TIME_DIGIT_HEIGHT 12
+#define HOURS_X 110     // Hours, e.g. "12H"
+#define LAP_ROWS 3
+#define LAP_Y 31
+#define LAP_ROW_HEIGHT 11
+#define LAP_CELLS 18        // LAP NN H:MM:SS.hh
+
+// Cells of the time in the large font, digits are 12 pixels, ':' and '.' 7
+static constexpr uint8_t time_cell_width[TIME_CELLS] = {12, 12, 7, 12, 12, 7, 12, 12};
+
+struct TimeCells {
+    uint8_t x[TIME_CELLS];
+
+    constexpr TimeCells() : x{} {
+        uint8_t width = 0;
+        for (uint8_t i = 0; i < TIME_CELLS; i++)
+            width += time_cell_width[i];
+        x[0] = (128 - width) / 2;
+        for (uint8_t i = 1; i < TIME_CELLS; i++)
+            x[i] = x[i-1] + time_cell_width[i-1];
+    }
+};
+
+static constexpr TimeCells time_cells;
+
+// Changed by Core 1 and read by Core 0
+static critical_section_t stopwatch_lock;
+static bool running = false;
+static uint64_t started_us = 0;     // Timer value when it was last started
+static uint64_t accumulated_us = 0; // Time before it was last started
+static uint64_t last_lap_us = 0;    // Elapsed time at the last lap
+static uint64_t laps[STOPWATCH_LAPS];
+static uint16_t lap_count = 0;
+
+// What is on the screen
+static char shown[TIME_CELLS];
+static char shown_hours[3];
+static uint16_t shown_lap_count = 0;
+static uint64_t next_frame_us = 0;
+
+void stopwatch_init() {
+    critical_section_init(&stopwatch_lock);
+}
+
+static uint64_t elapsed_us(uint64_t now_us) {
+    return running ? accumulated_us + (now_us - started_us) : accumulated_us;
+}
+
+void stopwatch_start_stop(uint64_t now_us) {
+    critical_section_enter_blocking(&stopwatch_lock);
+    if (running)
+        accumulated_us += now_us - started_us;
+    else
+        started_us = now_us;
+    running = !running;
+    critical_section_exit(&stopwatch_lock);
+}
+
+void stopwatch_lap(uint64_t now_us) {
+    critical_section_enter_blocking(&stopwatch_lock);
+    if (running) {
+        uint64_t elapsed = elapsed_us(now_us);
+        laps[lap_count % STOPWATCH_LAPS] = elapsed - last_lap_us;
+        last_lap_us = elapsed;
+        lap_count++;
+    }
+    critical_section_exit(&stopwatch_lock);
+}
+
+void stopwatch_reset() {
+    critical_section_enter_blocking(&stopwatch_lock);
+    if (!running) {
+        accumulated_us = 0;
+        last_lap_us = 0;
+        lap_count = 0;
+    }
+    critical_section_exit(&stopwatch_lock);
+}
+
+bool stopwatch_running() {
+    return running;
+}
+
+static void put_2digits(char* out, uint32_t value) {
+    out[0] = '0' + value / 10;
+    out[1] = '0' + value % 10;
+}
+
+// Writes MM:SS.hh of the time within the hour
+static void put_time(char* out, uint64_t us) {
+    uint32_t hundredths = us / 10000 % 360000;
+    put_2digits(out, hundredths / 6000);
+    out[2] = ':';
+    put_2digits(out + 3, hundredths / 100 % 60);
+    out[5] = '.';
+    put_2digits(out + 6, hundredths % 100);
+}
+
+static void draw_laps(Display& oled, const uint64_t* newest, uint8_t count, uint16_t number) {
+    oled.clearRegion(0, LAP_Y, 128, LAP_ROWS * LAP_ROW_HEIGHT);
+    char text[LAP_CELLS + 1] = "LAP NN H:MM:SS.hh";
+    for (uint8_t row = 0; row < count; row++, number--) {
+        put_2digits(text + 4, number % 100);
+        text[7] = '0' + newest[row] / 3600000000ull % 10;
+        put_time(text + 9, newest[row]);
+        oled.print((128 - LAP_CELLS * 6) / 2, LAP_Y + row * LAP_ROW_HEIGHT, (uint8_t *)text);
+    }
+}
+
+void draw_stopwatch(Display& oled, bool redraw) {
+    uint64_t now_us = time_us_64();
+    if (!redraw && now_us < next_frame_us)
+        return;
+    // Frames that fall behind are dropped rather than caught up with
+    next_frame_us = (now_us - next_frame_us < STOPWATCH_FRAME_US) ? next_frame_us + STOPWATCH_FRAME_US
+                                                                   : now_us + STOPWATCH_FRAME_US;
+
+    // Take a consistent copy, Core 1 may record a lap in the meantime
+    uint64_t newest[LAP_ROWS];
+    uint8_t lap_rows = 0;
+    critical_section_enter_blocking(&stopwatch_lock);
+    uint64_t elapsed = elapsed_us(now_us);
+    uint16_t count = lap_count;
+    if (redraw || count != shown_lap_count) {
+        for (; lap_rows < LAP_ROWS && lap_rows < count && lap_rows < STOPWATCH_LAPS; lap_rows++)
+            newest[lap_rows] = laps[(count - 1 - lap_rows) % STOPWATCH_LAPS];
+    }
+    critical_section_exit(&stopwatch_lock);
+
+    const GFXfont* font = oled.getFont();
+    if (redraw) {
+        oled.clear();
+        oled.setFont(&Compact_5x7);
+        oled.print(0, 0, (uint8_t *)"STOPWATCH");
+        oled.drawFastHLine(0, LAP_Y - 4, 128);
+        memset(shown, 0, sizeof(shown));
+        memset(shown_hours, 0, sizeof(shown_hours));
+    }
+
+    char text[TIME_CELLS];
+    put_time(text, elapsed);
+    for (uint8_t i = 0; i < TIME_CELLS; i++) {
+        if (text[i] == shown[i])
+            continue;
+        oled.clearRegion(time_cells.x[i], TIME_DIGIT_TOP, time_cell_width[i], TIME_DIGIT_HEIGHT);
+        oled.printChar(time_cells.x[i], 4, text[i]);
+        shown[i] = text[i];
+    }
+
+    oled.setFont(&Compact_5x7);
+    // Hours beside the title, only once the first hour is over
+    uint32_t hours = elapsed / 3600000000ull;
+    char hours_text[3] = {' ', ' ', ' '};
+    if (hours > 0) {
+        put_2digits(hours_text, hours % 100);
+        hours_text[2] = 'H';
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        if (hours_text[i] == shown_hours[i])
+            continue;
+        oled.clearRegion(HOURS_X + i * 6, 0, 6, 7);
+        oled.printChar(HOURS_X + i * 6, 0, hours_text[i]);
+        shown_hours[i] = hours_text[i];
+    }
+    if (redraw || count != shown_lap_count) {
+        draw_laps(oled, newest, lap_rows, count);
+        shown_lap_count = count;
+    }
+    oled.setFont(font);
+}
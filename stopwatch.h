@@ -0,0 +1,32 @@
+#ifndef _STOPWATCH_H_
+#define _STOPWATCH_H_
+
+#include "display.h"
+
+// Stopwatch timed with the microsecond timer, independently of the RTC.
+// Button presses are timestamped by Core 1 when they are seen, and Core 0
+// computes the elapsed time from those timestamps for every frame, so a
+// slow frame only shows the time later but never loses any of it.
+
+#define STOPWATCH_LAPS      16      // Laps kept in the ring, older ones are overwritten
+#define STOPWATCH_FRAME_US  33333   // 30 frames per second
+
+void stopwatch_init();
+
+// Starts or stops the stopwatch at the given timer value
+void stopwatch_start_stop(uint64_t now_us);
+
+// Records the time since the previous lap, only while running
+void stopwatch_lap(uint64_t now_us);
+
+// Clears the time and the laps, only while stopped
+void stopwatch_reset();
+
+bool stopwatch_running();
+
+// Draws the elapsed time and the latest laps. Only the digits that changed
+// are redrawn, at most once per STOPWATCH_FRAME_US; the laps only when a
+// lap is added. redraw draws the whole screen.
+void draw_stopwatch(Display& oled, bool redraw);
+
+#endif
@@ -0,0 +1,120 @@
+#include "OLED.h"
+#include "Dialog_bold_16.h"
+#include "timeformat.h"
+
+constexpr char weekdays[7][10] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+constexpr char months[12][4]   = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+constexpr char am_pm[2][3]     = {"AM", "PM"};
+
+template <uint8_t N, uint8_t L>
+struct WidthTable {
+    uint8_t width[N];
+
+    constexpr WidthTable(const char (&names)[N][L]) : width{} {
+        for (uint8_t i = 0; i < N; i++)
+            width[i] = textWidth(Dialog_bold_16, names[i]);
+    }
+};
+
+static constexpr WidthTable<7, 10> weekday_widths(weekdays);
+static constexpr WidthTable<12, 4> month_widths(months);
+static constexpr WidthTable<2, 3> am_pm_widths(am_pm);
+
+static constexpr uint8_t DIGIT_WIDTH = textWidth(Dialog_bold_16, "0");
+static_assert(textWidth(Dialog_bold_16, "0123456789") == 10 * DIGIT_WIDTH, "digits must have the same width");
+
+// Number of digits of a numeric field, 0 for names
+constexpr uint8_t field_digits(char field) {
+    return (field == F_YEAR[0]) ? 4 : (field == F_MONTH_NAME[0] || field == F_AM_PM[0]) ? 0 : 2;
+}
+
+constexpr uint8_t fixed_width(const char* program) {
+    uint8_t width = 0;
+    for (; *program; program++) {
+        if ((uint8_t)*program < ' ')
+            width += field_digits(*program) * DIGIT_WIDTH;
+        else
+            width += Dialog_bold_16.glyph[*program - Dialog_bold_16.first].xAdvance;
+    }
+    return width;
+}
+
+constexpr TimeFormat make_format(const char* program) {
+    return TimeFormat{program, fixed_width(program)};
+}
+
+constexpr ClockLayout clock_layouts[CLOCK_LAYOUT_COUNT] = {
+    {make_format(F_DAY " " F_MONTH_NAME " " F_YEAR), make_format(F_HOUR ":" F_MIN ":" F_SEC)},
+    {make_format(F_YEAR "-" F_MONTH "-" F_DAY), make_format(F_HOUR ":" F_MIN ":" F_SEC)},  // ISO 8601
+    {make_format(F_MONTH_NAME " " F_DAY " " F_YEAR), make_format(F_HOUR12 ":" F_MIN ":" F_SEC " " F_AM_PM)},
+    {make_format(F_DAY "." F_MONTH "." F_YEAR), make_format(F_HOUR ":" F_MIN)},
+};
+
+static_assert(clock_layouts[2].time.width + am_pm_widths.width[0] <= 128 &&
+                  clock_layouts[2].time.width + am_pm_widths.width[1] <= 128,
+              "12-hour time must fit the screen with AM and PM");
+
+static char* put_digits(char* out, uint16_t value, uint8_t digits) {
+    for (int8_t i = digits - 1; i >= 0; i--) {
+        out[i] = '0' + value % 10;
+        value /= 10;
+    }
+    return out + digits;
+}
+
+static char* put_name(char* out, const char* name) {
+    while (*name)
+        *out++ = *name++;
+    return out;
+}
+
+uint8_t format_time(const TimeFormat& format, const datetime_t* t, char* out) {
+    uint8_t width = format.width;
+    for (const char* op = format.program; *op; op++) {
+        switch (*op) {
+            case F_DAY[0]:
+                out = put_digits(out, t->day, 2);
+                break;
+            case F_MONTH[0]:
+                out = put_digits(out, t->month, 2);
+                break;
+            case F_MONTH_NAME[0]:
+                out = put_name(out, months[t->month-1]);
+                width += month_widths.width[t->month-1];
+                break;
+            case F_YEAR[0]:
+                out = put_digits(out, t->year, 4);
+                break;
+            case F_HOUR[0]:
+                out = put_digits(out, t->hour, 2);
+                break;
+            case F_HOUR12[0]:
+                out = put_digits(out, (t->hour % 12 == 0) ? 12 : t->hour % 12, 2);
+                break;
+            case F_MIN[0]:
+                out = put_digits(out, t->min, 2);
+                break;
+            case F_SEC[0]:
+                out = put_digits(out, t->sec, 2);
+                break;
+            case F_AM_PM[0]:
+                out = put_name(out, am_pm[t->hour >= 12]);
+                width += am_pm_widths.width[t->hour >= 12];
+                break;
+            default:
+                *out++ = *op;
+        }
+    }
+    *out = '\0';
+    return width;
+}
+
+char* format_number(char* out, uint16_t value, uint8_t digits) {
+    out = put_digits(out, value, digits);
+    *out = '\0';
+    return out;
+}
+
+uint8_t weekday_width(uint8_t dotw) {
+    return weekday_widths.width[dotw];
+}
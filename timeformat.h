@@ -0,0 +1,50 @@
+#ifndef _TIMEFORMAT_H_
+#define _TIMEFORMAT_H_
+
+#include "hardware/rtc.h"
+
+// Clock face layouts. A format is a tiny program: bytes below 0x20 are
+// fields and everything else is printed as is. Its pixel width without
+// the variable-width fields is computed at compile time, so rendering a
+// format is just writing digits and looking up the width of the month
+// name or AM/PM in a table.
+
+#define F_DAY        "\x01"
+#define F_MONTH      "\x02"
+#define F_MONTH_NAME "\x03"
+#define F_YEAR       "\x04"
+#define F_HOUR       "\x05"
+#define F_HOUR12     "\x06"
+#define F_MIN        "\x07"
+#define F_SEC        "\x08"
+#define F_AM_PM      "\x09"
+
+#define TIME_FORMAT_MAX_LENGTH 16
+
+extern const char weekdays[7][10];
+extern const char months[12][4];
+
+struct TimeFormat {
+    const char* program;
+    uint8_t width;  // Pixel width of the fixed-width part
+};
+
+struct ClockLayout {
+    TimeFormat date;
+    TimeFormat time;
+};
+
+#define CLOCK_LAYOUT_COUNT 4
+extern const ClockLayout clock_layouts[CLOCK_LAYOUT_COUNT];
+
+// Writes the text for t into out and returns its width in pixels
+uint8_t format_time(const TimeFormat& format, const datetime_t* t, char* out);
+
+// Writes value with digits digits and leading zeros, and returns the end of
+// the text, where more can be appended
+char* format_number(char* out, uint16_t value, uint8_t digits);
+
+// Returns the width of the weekday name in pixels
+uint8_t weekday_width(uint8_t dotw);
+
+#endif
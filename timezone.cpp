@@ -0,0 +1,54 @@
+#include "timezone.h"
+
+#define NO_DST {1, 1, 0, 0}
+
+constexpr TimeZone time_zones[TZ_COUNT] = {
+    {"UTC",    0,    0, NO_DST,              NO_DST},
+    {"LON",    0,   60, {3, 5, 0, 1 * 60},   {10, 5, 0, 2 * 60}},  // GMT/BST
+    {"BER",   60,  120, {3, 5, 0, 2 * 60},   {10, 5, 0, 3 * 60}},  // CET/CEST
+    {"TRT",  180,  180, NO_DST,              NO_DST},  // Istanbul
+    {"NYC", -300, -240, {3, 2, 0, 2 * 60},   {11, 1, 0, 2 * 60}},  // EST/EDT
+    {"TYO",  540,  540, NO_DST,              NO_DST},
+    {"SYD",  600,  660, {10, 1, 0, 2 * 60},  {4, 1, 0, 3 * 60}},   // AEST/AEDT
+};
+
+// Stored in flash, 4 bytes per zone and year
+static constexpr TzTable tables[TZ_COUNT] = {
+    TzTable(time_zones[0]), TzTable(time_zones[1]), TzTable(time_zones[2]), TzTable(time_zones[3]),
+    TzTable(time_zones[4]), TzTable(time_zones[5]), TzTable(time_zones[6]),
+};
+
+// 2022-03-27 01:00 UTC and 2022-10-30 01:00 UTC in Berlin
+static_assert(tables[TZ_BERLIN].dst_start[2] == (85 * 24 + 1) * 4, "wrong CEST start");
+static_assert(tables[TZ_BERLIN].dst_end[2] == (302 * 24 + 1) * 4, "wrong CEST end");
+// 2022-03-13 07:00 UTC in New York
+static_assert(tables[TZ_NEW_YORK].dst_start[2] == (71 * 24 + 7) * 4, "wrong EDT start");
+
+int16_t tz_offset(uint8_t zone, const datetime_t* utc) {
+    const TimeZone& tz = time_zones[zone];
+    const int16_t index = utc->year - TZ_FIRST_YEAR;
+    if (index < 0 || index >= TZ_YEARS)
+        return tz.std_offset;
+    const uint16_t start = tables[zone].dst_start[index];
+    const uint16_t end = tables[zone].dst_end[index];
+    const int32_t yday = days_from_civil(utc->year, utc->month, utc->day) - days_from_civil(utc->year, 1, 1);
+    const uint16_t quarter = (yday * 24 + utc->hour) * 4 + utc->min / 15;
+    // DST spans the new year on the southern hemisphere
+    const bool dst = (start <= end) ? (start <= quarter && quarter < end)
+                                    : (start <= quarter || quarter < end);
+    return dst ? tz.dst_offset : tz.std_offset;
+}
+
+void tz_shift(const datetime_t* from, datetime_t* to, int16_t minutes) {
+    *to = epoch_us_to_datetime(datetime_to_epoch_us(*from) + minutes * US_PER_MIN);
+}
+
+void tz_utc_to_local(uint8_t zone, const datetime_t* utc, datetime_t* local) {
+    tz_shift(utc, local, tz_offset(zone, utc));
+}
+
+void tz_local_to_utc(uint8_t zone, const datetime_t* local, datetime_t* utc) {
+    // Guess with standard time, then correct with the offset in effect then
+    tz_shift(local, utc, -time_zones[zone].std_offset);
+    tz_shift(local, utc, -tz_offset(zone, utc));
+}
@@ -0,0 +1,79 @@
+#ifndef _TIMEZONE_H_
+#define _TIMEZONE_H_
+
+#include "hardware/rtc.h"
+#include "calendar.h"
+#include "epoch.h"
+
+// The RTC runs in UTC. Local time is derived from it with per-zone tables
+// of DST transitions, which are computed from the zone rules at compile
+// time. A table holds the start and the end of DST in every year as
+// quarter hours since the beginning of the UTC year, so a conversion is a
+// single lookup and two comparisons.
+
+#define TZ_FIRST_YEAR 2020  // Years outside the table use standard time
+#define TZ_YEARS 80
+#define TZ_QUARTERS_PER_YEAR (366 * 24 * 4)
+
+enum TimeZones {TZ_UTC, TZ_LONDON, TZ_BERLIN, TZ_ISTANBUL, TZ_NEW_YORK, TZ_TOKYO, TZ_SYDNEY, TZ_COUNT};
+
+// DST switches on the given weekday of the given week of the month.
+// Week 5 means the last such weekday. The time is the local wall-clock
+// time that is in effect just before the switch, as in POSIX TZ rules.
+struct TzRule {
+    uint8_t month;
+    uint8_t week;
+    uint8_t dotw;
+    uint16_t minute;
+};
+
+struct TimeZone {
+    char name[4];        // Label for the screen
+    int16_t std_offset;  // Minutes east of UTC
+    int16_t dst_offset;  // Same as std_offset if the zone has no DST
+    TzRule dst_start;
+    TzRule dst_end;
+};
+
+// Returns the number of days since 1970-01-01 on which the rule fires
+constexpr int32_t tz_rule_day(int32_t year, const TzRule& rule) {
+    const int32_t first = days_from_civil(year, rule.month, 1);
+    int32_t day = first + (rule.dotw + 7 - day_of_week(first)) % 7 + 7 * (rule.week - 1);
+    while (day - first >= days_in_month(year, rule.month))
+        day -= 7;
+    return day;
+}
+
+// Returns the quarter hour of the UTC year on which the rule fires
+constexpr uint16_t tz_rule_quarter(int32_t year, const TzRule& rule, int16_t offset_before) {
+    const int32_t minutes = (tz_rule_day(year, rule) - days_from_civil(year, 1, 1)) * 1440 +
+                            rule.minute - offset_before;
+    return (minutes < 0) ? 0 : (minutes >= TZ_QUARTERS_PER_YEAR * 15) ? TZ_QUARTERS_PER_YEAR - 1 : minutes / 15;
+}
+
+struct TzTable {
+    uint16_t dst_start[TZ_YEARS];
+    uint16_t dst_end[TZ_YEARS];
+
+    constexpr TzTable(const TimeZone& zone) : dst_start{}, dst_end{} {
+        if (zone.std_offset == zone.dst_offset)
+            return;  // start == end, never in DST
+        for (uint8_t i = 0; i < TZ_YEARS; i++) {
+            dst_start[i] = tz_rule_quarter(TZ_FIRST_YEAR + i, zone.dst_start, zone.std_offset);
+            dst_end[i] = tz_rule_quarter(TZ_FIRST_YEAR + i, zone.dst_end, zone.dst_offset);
+        }
+    }
+};
+
+extern const TimeZone time_zones[TZ_COUNT];
+
+// Returns the UTC offset in minutes of the zone at the given UTC time
+int16_t tz_offset(uint8_t zone, const datetime_t* utc);
+
+// Shifts a time by the given number of minutes, the weekday follows the date
+void tz_shift(const datetime_t* from, datetime_t* to, int16_t minutes);
+
+void tz_utc_to_local(uint8_t zone, const datetime_t* utc, datetime_t* local);
+void tz_local_to_utc(uint8_t zone, const datetime_t* local, datetime_t* utc);
+
+#endif
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Reports where the code and data of the firmware ended up, from its ELF.
+
+    python3 tools/elf_report.py ram-functions <nm> <alarmclock.elf>
+    python3 tools/elf_report.py placement <nm> <alarmclock.elf> flash|sram <symbol>...
+    python3 tools/elf_report.py forbidden <nm> <alarmclock.elf> <symbol>...
+    python3 tools/elf_report.py memory <nm> <alarmclock.elf> <alarmclock.elf.map> <flash budget> <ram budget> [<other.elf.map>]
+
+ram-functions lists the functions that run from SRAM, largest first, e.g.
+the ones marked __not_in_flash. placement fails unless each symbol is
+defined once and lies in the given region, e.g. the font tables. Both are
+run after each build. forbidden fails if any of the functions is linked in,
+e.g. malloc, and then deletes the firmware files so they are not flashed
+and the next build links again. memory prints the flash and RAM used by
+each module, from the linker map, and the largest symbols, and fails if
+either total is over its budget in bytes. Initialised data counts for both.
+Given the map of another build, e.g. one without NO_HEAP_NO_PRINTF, it also
+prints how much each total and each module that differs saves against it.
+"""
+
+import os
+import subprocess
+import sys
+
+SRAM_START = 0x20000000
+SRAM_END = 0x20042000  # 264 KB, with the two 4 KB scratch banks
+FLASH_START = 0x10000000
+FLASH_END = 0x11000000  # XIP window
+
+REGIONS = {"flash": (FLASH_START, FLASH_END), "sram": (SRAM_START, SRAM_END)}
+
+
+def symbols(nm, elf):
+    """Yields (address, size, type, name) of the symbols that have a size."""
+    output = subprocess.run([nm, "--print-size", "--demangle", elf], check=True, capture_output=True,
+                            text=True).stdout
+    for line in output.splitlines():
+        fields = line.split(maxsplit=3)
+        if len(fields) == 4:
+            yield int(fields[0], 16), int(fields[1], 16), fields[2], fields[3]
+
+
+def ram_functions(nm, elf):
+    functions = [(size, name) for address, size, kind, name in symbols(nm, elf)
+                 if kind in "tT" and SRAM_START <= address < SRAM_END]
+    functions.sort(reverse=True)
+    print("Functions in SRAM:")
+    for size, name in functions:
+        print("%8d  %s" % (size, name))
+    print("%8d  total, %d functions" % (sum(size for size, _ in functions), len(functions)))
+
+
+def placement(nm, elf, region, names):
+    start, end = REGIONS[region]
+    found = {name: [] for name in names}
+    for address, _, _, name in symbols(nm, elf):
+        if name in found:
+            found[name].append(address)
+    errors = 0
+    for name, addresses in found.items():
+        if len(addresses) != 1:
+            print("%s: %d copies" % (name, len(addresses)))
+            errors += 1
+        elif not start <= addresses[0] < end:
+            print("%s: at 0x%08x, not in %s" % (name, addresses[0], region))
+            errors += 1
+    if errors:
+        sys.exit(1)
+    print("%d symbols in %s" % (len(names), region))
+
+
+def forbidden(nm, elf, names):
+    names = set(names)
+    # C++ names are matched without their parameters, e.g. "operator new"
+    linked = sorted({name.split("(")[0] for _, _, kind, name in symbols(nm, elf)
+                     if kind in "tTwW" and name.split("(")[0] in names})
+    if not linked:
+        print("none of %d forbidden functions linked" % len(names))
+        return
+    print("forbidden functions linked: " + ", ".join(linked))
+    stem = os.path.splitext(elf)[0]
+    for path in (elf, stem + ".uf2", stem + ".bin", stem + ".hex"):
+        if os.path.exists(path):
+            os.remove(path)
+    sys.exit(1)
+
+
+def map_sections(path):
+    """Yields (module, vma, size, lma) of the input sections in a linker map."""
+    with open(path) as f:
+        lines = f.read().splitlines()
+    try:
+        start = lines.index("Linker script and memory map") + 1
+    except ValueError:
+        sys.exit("%s: not a linker map" % path)
+    lma_offset = 0
+    pending = None  # Section name on a line of its own, its fields follow
+    for line in lines[start:]:
+        if pending is not None:
+            line, pending = pending + " " + line.strip(), None
+        fields = line.split()
+        if not fields or not fields[0].startswith(".") and fields[0] != "COMMON":
+            continue
+        if len(fields) == 1:
+            pending = line
+            continue
+        try:
+            vma, size = int(fields[1], 16), int(fields[2], 16)
+        except (IndexError, ValueError):
+            continue
+        if not line.startswith(" "):
+            # Output section, its contents are loaded from lma_offset on
+            lma_offset = 0
+            if fields[3:5] == ["load", "address"]:
+                lma_offset = int(fields[5], 16) - vma
+        elif len(fields) >= 4 and size:
+            yield module_name(" ".join(fields[3:])), vma, size, vma + lma_offset
+
+
+def module_name(path):
+    """libc_nano.a(lib_a-memcpy.o) -> libc_nano.a, .../OLED.cpp.obj -> OLED.cpp"""
+    path = path.split("(")[0].replace("\\", "/").rsplit("/", 1)[-1]
+    return path[:-4] if path.endswith(".obj") else path
+
+
+def in_region(region, address):
+    start, end = REGIONS[region]
+    return start <= address < end
+
+
+def module_usage(map_path):
+    """Returns {module: [flash, ram]} in bytes, from a linker map."""
+    modules = {}
+    for module, vma, size, lma in map_sections(map_path):
+        usage = modules.setdefault(module, [0, 0])
+        if in_region("flash", lma):
+            usage[0] += size
+        if in_region("sram", vma):
+            usage[1] += size
+    return modules
+
+
+def compare(modules, other_path):
+    other = module_usage(other_path)
+    print("Saved against %s:" % other_path)
+    print("%8s %8s  module" % ("flash", "ram"))
+    for module in sorted(set(modules) | set(other)):
+        usage, before = modules.get(module, [0, 0]), other.get(module, [0, 0])
+        if usage != before:
+            print("%8d %8d  %s" % (before[0] - usage[0], before[1] - usage[1], module))
+    for index, region in enumerate(REGIONS):
+        before = sum(usage[index] for usage in other.values())
+        used = sum(usage[index] for usage in modules.values())
+        print("%s: %d bytes saved, %d instead of %d" % (region, before - used, used, before))
+
+
+def memory(nm, elf, map_path, flash_budget, ram_budget, other_path=None):
+    modules = module_usage(map_path)
+    flash = sum(usage[0] for usage in modules.values())
+    ram = sum(usage[1] for usage in modules.values())
+
+    print("%8s %8s  module" % ("flash", "ram"))
+    for module, usage in sorted(modules.items(), key=lambda item: -max(item[1])):
+        if max(usage):
+            print("%8d %8d  %s" % (usage[0], usage[1], module))
+    for region in REGIONS:
+        largest = sorted(((size, name) for address, size, _, name in symbols(nm, elf)
+                          if size and in_region(region, address)), reverse=True)
+        print("Largest symbols in %s:" % region)
+        for size, name in largest[:20]:
+            print("%8d  %s" % (size, name))
+    if other_path:
+        compare(modules, other_path)
+
+    errors = 0
+    for region, used, budget in (("flash", flash, flash_budget), ("sram", ram, ram_budget)):
+        print("%s: %d of %d bytes, %d%%" % (region, used, budget, used * 100 // budget))
+        if used > budget:
+            print("%s is %d bytes over budget" % (region, used - budget))
+            errors += 1
+    if errors:
+        sys.exit(1)
+
+
+def main():
+    if len(sys.argv) == 4 and sys.argv[1] == "ram-functions":
+        ram_functions(sys.argv[2], sys.argv[3])
+    elif len(sys.argv) >= 6 and sys.argv[1] == "placement" and sys.argv[4] in REGIONS:
+        placement(sys.argv[2], sys.argv[3], sys.argv[4], sys.argv[5:])
+    elif len(sys.argv) >= 5 and sys.argv[1] == "forbidden":
+        forbidden(sys.argv[2], sys.argv[3], sys.argv[4:])
+    elif len(sys.argv) in (7, 8) and sys.argv[1] == "memory":
+        memory(sys.argv[2], sys.argv[3], sys.argv[4], int(sys.argv[5], 0), int(sys.argv[6], 0), *sys.argv[7:])
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    main()
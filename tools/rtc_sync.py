@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+"""Sends the host time to the alarm clock over USB serial for RTC calibration.
+
+The first sync sets the clock, later ones measure the drift of the RTC.
+Keep it running for a while (at least DRIFT_MIN_REFERENCE_SEC) with an
+NTP-synced host clock. The clock prints the measured drift after each sync.
+
+    python3 tools/rtc_sync.py /dev/ttyACM0 [interval seconds]
+"""
+
+import os
+import select
+import sys
+import time
+import tty
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    port = sys.argv[1]
+    interval = float(sys.argv[2]) if len(sys.argv) > 2 else 60.0
+
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    try:
+        while True:
+            os.write(fd, b"T%d\n" % (time.time_ns() // 1000))
+            deadline = time.monotonic() + interval
+            while (remaining := deadline - time.monotonic()) > 0:
+                ready, _, _ = select.select([fd], [], [], remaining)
+                if ready:
+                    sys.stdout.write(os.read(fd, 256).decode(errors="replace"))
+                    sys.stdout.flush()
+    finally:
+        os.close(fd)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,121 @@
+#include <cstring>
+
+#include "hardware/rtc.h"
+#include "worldclock.h"
+#include "Compact_5x7.h"
+#include "timezone.h"
+
+#define ROWS (WORLD_CLOCK_ZONES + 1)
+#define CELLS 10  // HH:MM:SS and the day difference
+#define TIME_X 30
+#define LOCAL_DIGIT_TOP 7 // Top row of the digits printed at y = 0
+#define LOCAL_DIGIT_HEIGHT 12
+#define ZONE_Y 27
+#define ZONE_ROW_HEIGHT 12
+#define COMPACT_ADVANCE 6
+
+const uint8_t world_clock_zones[WORLD_CLOCK_ZONES] = {TZ_NEW_YORK, TZ_TOKYO, TZ_SYDNEY};
+
+// Cells of the local time in the large font, digits are 12 pixels and colons 7
+static constexpr uint8_t local_cell_x[8] = {TIME_X, TIME_X + 12, TIME_X + 24, TIME_X + 31,
+                                            TIME_X + 43, TIME_X + 55, TIME_X + 62, TIME_X + 74};
+static constexpr uint8_t local_cell_width[8] = {12, 12, 7, 12, 12, 7, 12, 12};
+
+// Cells of the other zones in the compact font, the day difference is apart from the time
+static constexpr uint8_t zone_cell_x[CELLS] = {TIME_X, TIME_X + 6, TIME_X + 12, TIME_X + 18, TIME_X + 24,
+                                               TIME_X + 30, TIME_X + 36, TIME_X + 42, TIME_X + 66, TIME_X + 72};
+static constexpr uint8_t zone_cell_width[CELLS] = {6, 6, 6, 6, 6, 6, 6, 6, 6, 6};
+
+static char shown[ROWS][CELLS + 1];  // Text on the screen, '\0' for an empty cell
+static int16_t offsets[ROWS];
+static int8_t offsets_min = -1;
+static int8_t shown_sec = -1;
+static uint64_t next_read_us = 0;
+
+static void put_2digits(char* out, uint8_t value) {
+    out[0] = '0' + value / 10;
+    out[1] = '0' + value % 10;
+}
+
+// Writes HH:MM:SS of the UTC second of day shifted by offset minutes,
+// and returns the day relative to the UTC day
+static int8_t zone_time(int32_t utc_second, int16_t offset, char* out) {
+    int32_t second = utc_second + offset * 60;
+    int8_t day = 0;
+    if (second < 0) {
+        second += 86400;
+        day = -1;
+    }
+    else if (second >= 86400) {
+        second -= 86400;
+        day = 1;
+    }
+    put_2digits(out, second / 3600);
+    out[2] = ':';
+    put_2digits(out + 3, second / 60 % 60);
+    out[5] = ':';
+    put_2digits(out + 6, second % 60);
+    return day;
+}
+
+// Redraws the cells of text that differ from what is on the screen
+static void draw_cells(Display& oled, const char* text, char* on_screen, uint8_t count, const uint8_t* cell_x,
+                       const uint8_t* cell_width, uint8_t y, uint8_t top, uint8_t height) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (text[i] == on_screen[i])
+            continue;
+        oled.clearRegion(cell_x[i], top, cell_width[i], height);
+        oled.printChar(cell_x[i], y, text[i]);
+        on_screen[i] = text[i];
+    }
+}
+
+void draw_world_clock(Display& oled, uint8_t local_zone, bool redraw) {
+    uint64_t now_us = time_us_64();
+    if (!redraw && now_us < next_read_us)
+        return;
+    datetime_t utc;
+    rtc_get_datetime(&utc);
+    if (!redraw && utc.sec == shown_sec) {
+        next_read_us = now_us + 5000;  // The second is about to change
+        return;
+    }
+    next_read_us = now_us + 990000;
+    shown_sec = utc.sec;
+
+    const GFXfont* font = oled.getFont();
+    if (redraw) {
+        // Static parts: zone labels and a separator
+        oled.clear();
+        oled.setFont(&Compact_5x7);
+        oled.print(0, LOCAL_DIGIT_TOP + 2, (uint8_t *)time_zones[local_zone].name);
+        for (uint8_t i = 0; i < WORLD_CLOCK_ZONES; i++)
+            oled.print(0, ZONE_Y + i * ZONE_ROW_HEIGHT, (uint8_t *)time_zones[world_clock_zones[i]].name);
+        oled.drawFastHLine(0, ZONE_Y - 4, 128);
+        memset(shown, 0, sizeof(shown));
+        offsets_min = -1;
+    }
+    // DST changes on quarter hours at the earliest, once a minute is enough
+    if (utc.min != offsets_min) {
+        offsets[0] = tz_offset(local_zone, &utc);
+        for (uint8_t i = 0; i < WORLD_CLOCK_ZONES; i++)
+            offsets[i + 1] = tz_offset(world_clock_zones[i], &utc);
+        offsets_min = utc.min;
+    }
+
+    int32_t utc_second = utc.hour * 3600 + utc.min * 60 + utc.sec;
+    char text[CELLS];
+    int8_t local_day = zone_time(utc_second, offsets[0], text);
+    oled.setFont(font);
+    draw_cells(oled, text, shown[0], 8, local_cell_x, local_cell_width, 0, LOCAL_DIGIT_TOP, LOCAL_DIGIT_HEIGHT);
+
+    oled.setFont(&Compact_5x7);
+    for (uint8_t row = 1; row < ROWS; row++) {
+        int8_t day = zone_time(utc_second, offsets[row], text) - local_day;
+        text[8] = (day < 0) ? '-' : (day > 0) ? '+' : ' ';
+        text[9] = (day != 0) ? '1' : ' ';
+        uint8_t y = ZONE_Y + (row - 1) * ZONE_ROW_HEIGHT;
+        draw_cells(oled, text, shown[row], CELLS, zone_cell_x, zone_cell_width, y, y, 7);
+    }
+    oled.setFont(font);
+}
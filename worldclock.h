@@ -0,0 +1,17 @@
+#ifndef _WORLDCLOCK_H_
+#define _WORLDCLOCK_H_
+
+#include "display.h"
+
+#define WORLD_CLOCK_ZONES 3
+
+// Zones shown below the local time
+extern const uint8_t world_clock_zones[WORLD_CLOCK_ZONES];
+
+// Draws the local time in large digits and the other zones in the compact
+// font below it. The RTC is read about once per second, the UTC offsets
+// once per minute, and only the character cells that changed are redrawn.
+// redraw draws the whole screen, e.g. when the screen is entered.
+void draw_world_clock(Display& oled, uint8_t local_zone, bool redraw);
+
+#endif